@@ -9,18 +9,25 @@
 #include "vulkan/vulkan_capture.h"
 #include "vulkan/vulkan_compute.h"
 #include "interpolation/rife_engine.h"
+#include "interpolation/cpu_blend_backend.h"
 #include "interpolation/motion_estimator.h"
 #include "interpolation/optical_flow.h"
 #include "pipeline/frame_queue.h"
 #include "pipeline/frame_presenter.h"
 #include "pipeline/timing_controller.h"
 #include "utils/perf_monitor.h"
-#include "utils/shader_compiler.h"
+#include "utils/shader_registry.h"
+#include "utils/asset_bundle.h"
+
+#if NCNN_ENABLED
+#include <gpu.h>
+#endif
 
 #include <jni.h>
 #include <android/native_window_jni.h>
 #include <android/asset_manager_jni.h>
 #include <memory>
+#include <cstring>
 
 using namespace framegen;
 
@@ -38,6 +45,9 @@ struct EngineState {
     std::unique_ptr<TimingController> timing;
     std::unique_ptr<PerfMonitor> perfMonitor;
 
+    // Models, mapped once for the engine's lifetime
+    AssetBundle bundle;
+
     VkInstance vkInstance = VK_NULL_HANDLE;
     VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
     VkDevice vkDevice = VK_NULL_HANDLE;
@@ -46,6 +56,19 @@ struct EngineState {
     VkSurfaceKHR surface = VK_NULL_HANDLE;
     VkSwapchainKHR swapchain = VK_NULL_HANDLE;
 
+    // Reduced-precision shader arithmetic enabled on vkDevice
+    bool shaderFloat16 = false;
+    bool shaderInt8 = false;
+
+    // Queue family VulkanCompute and VulkanCapture run on
+    uint32_t engineQueueFamily = 0;
+
+#if NCNN_ENABLED
+    // Set when vkDevice is NCNN's (see adoptNcnnDevice); not ours to destroy
+    ncnn::VulkanDevice* ncnnDevice = nullptr;
+    uint32_t graphicsQueueFamily = 0;   // graphicsQueue, taken from NCNN's pool
+#endif
+
     ANativeWindow* window = nullptr;
     AAssetManager* assetManager = nullptr;
 
@@ -152,16 +175,51 @@ static bool createLogicalDevice() {
         queueInfos.push_back(computeQueueInfo);
     }
 
-    const char* deviceExtensions[] = {
+    std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
     };
 
+    // FP16/INT8 shader arithmetic (VK_KHR_shader_float16_int8 on Vulkan 1.1)
+    uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(g_engine.vkPhysicalDevice, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> availableExts(extCount);
+    vkEnumerateDeviceExtensionProperties(g_engine.vkPhysicalDevice, nullptr, &extCount, availableExts.data());
+
+    bool hasFloat16Int8Ext = false;
+    for (const auto& ext : availableExts) {
+        if (strcmp(ext.extensionName, VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME) == 0) {
+            hasFloat16Int8Ext = true;
+            break;
+        }
+    }
+
+    VkPhysicalDeviceShaderFloat16Int8Features float16Int8{};
+    float16Int8.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES;
+
+    if (hasFloat16Int8Ext) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &float16Int8;
+        vkGetPhysicalDeviceFeatures2(g_engine.vkPhysicalDevice, &features2);
+        float16Int8.pNext = nullptr;
+
+        g_engine.shaderFloat16 = float16Int8.shaderFloat16 == VK_TRUE;
+        g_engine.shaderInt8 = float16Int8.shaderInt8 == VK_TRUE;
+        if (g_engine.shaderFloat16 || g_engine.shaderInt8) {
+            deviceExtensions.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+        }
+    }
+
+    LOGI("Shader arithmetic: float16=%s int8=%s",
+         g_engine.shaderFloat16 ? "yes" : "no", g_engine.shaderInt8 ? "yes" : "no");
+
     VkDeviceCreateInfo deviceInfo{};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.pNext = (g_engine.shaderFloat16 || g_engine.shaderInt8) ? &float16Int8 : nullptr;
     deviceInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
     deviceInfo.pQueueCreateInfos = queueInfos.data();
-    deviceInfo.enabledExtensionCount = 1;
-    deviceInfo.ppEnabledExtensionNames = deviceExtensions;
+    deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     if (vkCreateDevice(g_engine.vkPhysicalDevice, &deviceInfo, nullptr, &g_engine.vkDevice) != VK_SUCCESS) {
         return false;
@@ -173,6 +231,80 @@ static bool createLogicalDevice() {
     return true;
 }
 
+#if NCNN_ENABLED
+/**
+ * Run the engine on NCNN's VkDevice so RIFE can read captured frames and
+ * write its output without leaving the GPU. NCNN cannot wrap a VkDevice
+ * it did not create, so the sharing goes this way round. One compute
+ * queue and one graphics queue for presenting are taken from NCNN's pool
+ * for the engine's lifetime, leaving NCNN at least one compute queue.
+ * Without VK_KHR_swapchain or spare queues the caller creates its own
+ * device instead.
+ */
+static bool adoptNcnnDevice() {
+    ncnn::create_gpu_instance();
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(g_engine.vkPhysicalDevice, &props);
+
+    for (int i = 0; i < ncnn::get_gpu_count(); i++) {
+        const ncnn::GpuInfo& info = ncnn::get_gpu_info(i);
+        if (info.vendor_id() != props.vendorID || info.device_id() != props.deviceID) continue;
+
+        if (info.compute_queue_count() < 2) {
+            LOGW("NCNN device has %u compute queue(s) — creating a separate device",
+                 info.compute_queue_count());
+            return false;
+        }
+
+        // NCNN enables VK_KHR_swapchain only when the device has it
+        if (!info.support_VK_KHR_swapchain()) {
+            LOGW("NCNN device has no VK_KHR_swapchain — creating a separate device");
+            return false;
+        }
+
+        // acquire_queue() blocks until a queue is free, so count first: a
+        // graphics family shared with compute must spare a third queue
+        uint32_t computeFamily = info.compute_queue_family_index();
+        uint32_t graphicsFamily = info.graphics_queue_family_index();
+        if (graphicsFamily == computeFamily && info.compute_queue_count() < 3) {
+            LOGW("NCNN device has no spare graphics queue — creating a separate device");
+            return false;
+        }
+
+        ncnn::VulkanDevice* vkdev = ncnn::get_gpu_device(i);
+        if (!vkdev) return false;
+
+        VkQueue computeQueue = vkdev->acquire_queue(computeFamily);
+        VkQueue graphicsQueue = vkdev->acquire_queue(graphicsFamily);
+        if (computeQueue == VK_NULL_HANDLE || graphicsQueue == VK_NULL_HANDLE) {
+            LOGE("Failed to take queues from NCNN's pool");
+            if (computeQueue != VK_NULL_HANDLE) vkdev->reclaim_queue(computeFamily, computeQueue);
+            if (graphicsQueue != VK_NULL_HANDLE) vkdev->reclaim_queue(graphicsFamily, graphicsQueue);
+            return false;
+        }
+
+        g_engine.ncnnDevice = vkdev;
+        g_engine.vkPhysicalDevice = info.physical_device();
+        g_engine.vkDevice = vkdev->vkdevice();
+        g_engine.engineQueueFamily = computeFamily;
+        g_engine.computeQueue = computeQueue;
+        g_engine.graphicsQueueFamily = graphicsFamily;
+        g_engine.graphicsQueue = graphicsQueue;
+
+        // NCNN enables these features itself when the device has them
+        g_engine.shaderFloat16 = info.support_fp16_arithmetic();
+        g_engine.shaderInt8 = info.support_int8_arithmetic();
+
+        LOGI("Sharing NCNN VkDevice (GPU %d, queue family %u)", i, g_engine.engineQueueFamily);
+        return true;
+    }
+
+    LOGW("NCNN has no device matching the selected GPU");
+    return false;
+}
+#endif
+
 // ============================================================
 // JNI Functions
 // ============================================================
@@ -228,39 +360,64 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeInit(
         return JNI_FALSE;
     }
 
-    if (!createLogicalDevice()) {
+    bool sharedDevice = false;
+#if NCNN_ENABLED
+    sharedDevice = adoptNcnnDevice();
+#endif
+    if (!sharedDevice && !createLogicalDevice()) {
         LOGE("Failed to create logical device");
         return JNI_FALSE;
     }
 
     // Step 2: Initialize compute pipeline
     g_engine.compute = std::make_unique<VulkanCompute>();
-    if (!g_engine.compute->init(g_engine.vkDevice, g_engine.vkPhysicalDevice, 0)) {
+    if (!g_engine.compute->init(g_engine.vkDevice, g_engine.vkPhysicalDevice,
+                                g_engine.engineQueueFamily,
+                                sharedDevice ? g_engine.computeQueue : VK_NULL_HANDLE)) {
         LOGE("Failed to init VulkanCompute");
         return JNI_FALSE;
     }
-
-    // Step 3: Load compute shaders from assets
-    auto loadShader = [&](const char* name, const char* asset) {
-        auto spirv = ShaderCompiler::loadFromAsset(g_engine.assetManager, asset);
-        if (!spirv.empty()) {
-            g_engine.compute->loadShader(name, spirv.data(), spirv.size() * sizeof(uint32_t));
+    g_engine.compute->enableArithmeticTypes(g_engine.shaderFloat16, g_engine.shaderInt8);
+
+    // Step 3: Load compute shaders embedded at build time. Pipelines are
+    // created from the reflected layouts when each stage initializes.
+    auto loadShader = [&](const char* name, const char* embedded) {
+        const ShaderInfo* info = ShaderRegistry::find(embedded);
+        if (info) {
+            g_engine.compute->loadShader(name, *info);
         }
     };
 
-    loadShader("optical_flow", "shaders/optical_flow.spv");
-    loadShader("frame_warp", "shaders/frame_warp.spv");
-    loadShader("frame_blend", "shaders/frame_blend.spv");
-    loadShader("downsample", "shaders/downsample.spv");
-    loadShader("block_match", "shaders/block_match.spv");
-    loadShader("flow_refine", "shaders/flow_refine.spv");
-    loadShader("flow_consistency", "shaders/flow_consistency.spv");
-    loadShader("rgb_to_gray", "shaders/rgb_to_gray.spv");
+    // Reduced-precision variants are registered under the FP32 name, so
+    // pipeline creation and dispatch are unchanged
+    const auto& caps = g_engine.compute->getCapabilities();
+
+    loadShader("optical_flow", "optical_flow");
+    loadShader("frame_warp", caps.shaderFloat16 ? "frame_warp_fp16"
+                                                : "frame_warp");
+    loadShader("frame_blend", caps.shaderFloat16 ? "frame_blend_fp16"
+                                                 : "frame_blend");
+    loadShader("downsample", "downsample");
+
+    // Block matching: uint8 luma tile if available; else reduce each block
+    // over an 8-lane subgroup cluster; else through shared memory
+    bool subgroupMatch = caps.subgroupClustered && caps.subgroupSize >= 8;
+    loadShader("block_match", caps.shaderInt8 ? "block_match_int8"
+                            : subgroupMatch  ? "block_match_subgroup"
+                                             : "block_match");
+    loadShader("flow_refine", "flow_refine");
+    loadShader("flow_consistency", "flow_consistency");
+    loadShader("rgb_to_gray", caps.shaderFloat16 ? "rgb_to_gray_fp16"
+                                                 : "rgb_to_gray");
+    loadShader("rife_preprocess", "rife_preprocess");
+    loadShader("rife_postprocess", "rife_postprocess");
+    loadShader("rife_tile_postprocess", "rife_tile_postprocess");
 
     // Step 4: Initialize frame capture
     g_engine.capture = std::make_unique<VulkanCapture>();
     if (!g_engine.capture->init(g_engine.vkDevice, g_engine.vkPhysicalDevice,
-                                 0, width, height, VK_FORMAT_R8G8B8A8_UNORM)) {
+                                 g_engine.engineQueueFamily, width, height, VK_FORMAT_R8G8B8A8_UNORM,
+                                 FramePresenter::CAPTURE_RING_SIZE)) {
         LOGE("Failed to init VulkanCapture");
         return JNI_FALSE;
     }
@@ -269,11 +426,27 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeInit(
     g_engine.rife = std::make_unique<RifeEngine>();
     // Model files should be in app's files dir
     std::string modelDir = "/data/data/com.framegen.app/files/models";
-    g_engine.rife->init(modelDir, g_engine.compute.get(), g_engine.config);
-
-    // Step 6: Initialize motion estimator
+    g_engine.bundle.open(modelDir + "/framegen.bundle");  // Optional; loose files otherwise
+    g_engine.rife->init(modelDir, g_engine.compute.get(), g_engine.config,
+                        g_engine.bundle.isOpen() ? &g_engine.bundle : nullptr);
+    g_engine.rife->registerBackend(
+        std::make_unique<CpuBlendBackend>(g_engine.compute.get(), g_engine.config));
+
+    // Step 6: Initialize motion estimator — the flow for extrapolation and
+    // the compute backend, so before the backends are tuned
     g_engine.motionEstimator = std::make_unique<MotionEstimator>();
-    g_engine.motionEstimator->init(g_engine.compute.get(), width, height);
+    if (!g_engine.motionEstimator->init(g_engine.compute.get(), width, height) ||
+        !g_engine.rife->setMotionEstimator(g_engine.motionEstimator.get())) {
+        LOGW("Extrapolation and the compute backend unavailable");
+        g_engine.config.extrapolation = false;
+    }
+
+    // Backend choice is measured once per device and resolution
+    std::string tuneCache = "/data/data/com.framegen.app/files/backend_autotune.txt";
+    if (!g_engine.rife->prepare(width, height, tuneCache)) {
+        LOGE("No interpolation backend usable at %ux%u", width, height);
+        return JNI_FALSE;
+    }
 
     // Step 7: Initialize optical flow
     g_engine.opticalFlow = std::make_unique<OpticalFlow>();
@@ -292,6 +465,8 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeInit(
     FramePresenter::InitParams presenterParams;
     presenterParams.capture = g_engine.capture.get();
     presenterParams.interpolator = g_engine.rife.get();
+    presenterParams.compute = g_engine.compute.get();
+    if (g_engine.config.adaptive_quality) presenterParams.timing = g_engine.timing.get();
     presenterParams.device = g_engine.vkDevice;
     presenterParams.presentQueue = g_engine.graphicsQueue;
     presenterParams.width = width;
@@ -303,6 +478,14 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeInit(
         return JNI_FALSE;
     }
 
+    // RIFE's descriptor caches are keyed by capture ring and output pool
+    // images; both sets are fixed now
+    if (!g_engine.rife->reserveDescriptorSets(g_engine.capture->getBufferCount(),
+                                              g_engine.presenter->getOutputPoolSize())) {
+        LOGE("Failed to reserve descriptor sets");
+        return JNI_FALSE;
+    }
+
     g_engine.initialized = true;
     LOGI("=== FrameGen Engine Ready ===");
     return JNI_TRUE;
@@ -354,6 +537,17 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeDestroy(JNIEnv* env, jobject t
     g_engine.compute.reset();
     g_engine.timing.reset();
     g_engine.perfMonitor.reset();
+    g_engine.bundle.close();
+
+#if NCNN_ENABLED
+    if (g_engine.ncnnDevice) {
+        g_engine.ncnnDevice->reclaim_queue(g_engine.engineQueueFamily, g_engine.computeQueue);
+        g_engine.ncnnDevice->reclaim_queue(g_engine.graphicsQueueFamily, g_engine.graphicsQueue);
+        g_engine.ncnnDevice = nullptr;
+        g_engine.vkDevice = VK_NULL_HANDLE;  // Destroyed with the GPU instance
+    }
+    ncnn::destroy_gpu_instance();
+#endif
 
     if (g_engine.vkDevice != VK_NULL_HANDLE) {
         vkDestroyDevice(g_engine.vkDevice, nullptr);
@@ -380,16 +574,33 @@ Java_com_framegen_app_engine_FrameGenEngine_nativeSetMode(JNIEnv* env, jobject t
     }
 }
 
+/**
+ * Extrapolate past the newest frame instead of interpolating behind it
+ */
+JNIEXPORT void JNICALL
+Java_com_framegen_app_engine_FrameGenEngine_nativeSetExtrapolation(JNIEnv* env, jobject thiz,
+                                                                   jboolean enabled) {
+    // Needs the motion estimator's flow; off if it failed to initialize
+    bool available = g_engine.rife && g_engine.rife->canExtrapolate();
+    if (enabled == JNI_TRUE && !available) {
+        LOGW("Extrapolation unavailable — staying on interpolation");
+    }
+    g_engine.config.extrapolation = enabled == JNI_TRUE && available;
+    if (g_engine.presenter) {
+        g_engine.presenter->setExtrapolation(g_engine.config.extrapolation);
+    }
+}
+
 /**
  * Set quality (0.0 - 1.0)
  */
 JNIEXPORT void JNICALL
 Java_com_framegen_app_engine_FrameGenEngine_nativeSetQuality(JNIEnv* env, jobject thiz, jfloat quality) {
     g_engine.config.quality = quality;
+    // The presenter passes it on to the engine and the timing controller
     if (g_engine.presenter) {
         g_engine.presenter->setQuality(quality);
-    }
-    if (g_engine.rife) {
+    } else if (g_engine.rife) {
         g_engine.rife->setQuality(quality);
     }
 }
@@ -29,16 +29,26 @@
 namespace framegen {
 
 struct Config {
-    // Target interpolation mode
+    // Target output rate; frames are generated for whatever display slots
+    // the measured game rate leaves open (e.g. 40->120: 2 per pair)
     enum class Mode : uint8_t {
         OFF       = 0,  // Passthrough
-        FPS_60    = 1,  // 30->60 (1 interpolated frame)
-        FPS_90    = 2,  // 30->90 (2 interpolated frames)
-        FPS_120   = 3,  // 30->120 (3 interpolated) or 60->120 (1 interpolated)
+        FPS_60    = 1,  // Output 60 fps
+        FPS_90    = 2,  // Output 90 fps
+        FPS_120   = 3,  // Output 120 fps
     };
 
     Mode mode = Mode::FPS_60;
 
+    // Predict frames past the newest one (from the last flow field)
+    // instead of waiting for the next: the newest frame presents at once,
+    // trading disocclusion artifacts for a frame interval of latency
+    bool extrapolation = false;
+
+    // Flow disagreement (pixels) at which an extrapolated pixel counts as
+    // disoccluded and is filled from the newest frame
+    float extrapolation_occlusion_px = 2.0f;
+
     // Maximum time budget for one interpolated frame (nanoseconds)
     uint64_t max_frame_time_ns = 8'000'000;  // 8ms
 
@@ -48,9 +58,36 @@ struct Config {
     // Resolution scale for the AI model (1.0 = full res, 0.5 = half res)
     float model_scale = 0.5f;
 
+    // Let the timing controller pick the model scale and search radius
+    // from measured stage costs, instead of keeping the ones set here
+    bool adaptive_quality = true;
+
+    // Tiled RIFE inference: model-space frames wider or taller than this
+    // run as overlapping tiles (multiple of 32; 0 = never tile)
+    uint32_t rife_tile_size = 512;
+
+    // Overlap between neighbouring tiles, feathered across (model pixels)
+    uint32_t rife_tile_overlap = 32;
+
+    // Hand captures to the interpolation thread through a latest-wins
+    // mailbox instead of a queue: under load it works on the newest pair
+    // and skips (supersedes) older captures rather than draining a backlog
+    bool capture_mailbox = false;
+
     // Number of frames in the ring buffer
     uint32_t ring_buffer_size = 4;
 
+    // Worker threads per pipeline stage: motion estimation of one pair
+    // overlaps synthesis of the one before it (extrapolation and the
+    // compute backend; RIFE infers flow in synthesis). Estimation runs on one
+    // worker: the estimator's pyramid scratch images are shared
+    uint32_t estimate_workers = 1;
+    uint32_t synthesis_workers = 1;
+
+    // Pin engine threads to CPU clusters by role (big.LITTLE); priorities
+    // are raised either way
+    bool thread_affinity = true;
+
     // Enable GPU thermal throttling protection
     bool thermal_protection = true;
 
@@ -58,6 +95,18 @@ struct Config {
     uint32_t target_refresh_rate = 120;
 };
 
+// Model scales RifeEngine keeps inference resources for, and the timing
+// controller chooses between
+inline constexpr size_t MODEL_SCALE_RUNGS = 3;
+inline constexpr float MODEL_SCALE_LADDER[MODEL_SCALE_RUNGS] = {0.25f, 0.5f, 0.75f};
+
+// The rung a user quality setting (0.0-1.0) selects
+inline constexpr float modelScaleForQuality(float quality) {
+    if (quality < 0.3f) return MODEL_SCALE_LADDER[0];  // Quarter res — fastest
+    if (quality < 0.6f) return MODEL_SCALE_LADDER[1];  // Half res — balanced
+    return MODEL_SCALE_LADDER[2];                      // 3/4 res — high quality
+}
+
 // ============================================================
 // Frame descriptor
 // ============================================================
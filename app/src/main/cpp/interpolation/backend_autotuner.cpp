@@ -0,0 +1,348 @@
+/**
+ * Backend Autotuner implementation
+ */
+
+#include "backend_autotuner.h"
+#include "../utils/gpu_buffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace framegen {
+
+namespace {
+
+uint32_t findDeviceLocalMemory(VkPhysicalDevice physicalDevice, uint32_t typeFilter) {
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) &&
+            (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+BackendAutotuner::~BackendAutotuner() {
+    destroyFrames();
+}
+
+int BackendAutotuner::select(const std::vector<InterpolationBackend*>& backends,
+                             uint32_t width, uint32_t height, float budgetMs,
+                             const std::string& cachePath) {
+    if (backends.empty()) return -1;
+
+    std::string key = deviceKey(width, height);
+    std::string cached;
+    if (!cachePath.empty() && readCache(cachePath, key, cached)) {
+        for (size_t i = 0; i < backends.size(); i++) {
+            if (cached == backends[i]->name() && backends[i]->prepare(width, height)) {
+                LOGI("BackendAutotuner: Using cached choice %s for %s", cached.c_str(), key.c_str());
+                return static_cast<int>(i);
+            }
+        }
+        LOGW("BackendAutotuner: Cached backend %s unavailable — retuning", cached.c_str());
+    }
+
+    if (!createFrames(width, height)) {
+        LOGE("BackendAutotuner: Failed to create synthetic frames");
+        destroyFrames();
+        return -1;
+    }
+
+    int best = -1;
+    float bestMs = 0.0f;
+    for (size_t i = 0; i < backends.size(); i++) {
+        InterpolationBackend& backend = *backends[i];
+        if (!backend.prepare(width, height)) {
+            LOGW("BackendAutotuner: %s unavailable at %ux%u", backend.name(), width, height);
+            backend.release();
+            continue;
+        }
+
+        float ms = measure(backend);
+        if (ms < 0.0f) {
+            LOGW("BackendAutotuner: %s failed on %ux%u", backend.name(), width, height);
+            backend.release();
+            continue;
+        }
+        LOGI("BackendAutotuner: %s: %.2f ms/frame (tier %d, budget %.2f ms)",
+             backend.name(), ms, backend.qualityTier(), budgetMs);
+
+        if (best < 0) {
+            best = static_cast<int>(i);
+            bestMs = ms;
+            continue;
+        }
+
+        // Fitting the budget first, then quality tier, then speed
+        const InterpolationBackend& current = *backends[best];
+        bool fits = ms < budgetMs;
+        bool bestFits = bestMs < budgetMs;
+        bool better;
+        if (fits != bestFits) {
+            better = fits;
+        } else if (fits && backend.qualityTier() != current.qualityTier()) {
+            better = backend.qualityTier() > current.qualityTier();
+        } else {
+            better = ms < bestMs;
+        }
+        if (better) {
+            backends[best]->release();
+            best = static_cast<int>(i);
+            bestMs = ms;
+        } else {
+            backend.release();
+        }
+    }
+
+    destroyFrames();
+
+    if (best < 0) return -1;
+
+    if (bestMs >= budgetMs) {
+        LOGW("BackendAutotuner: No backend fits %.2f ms; fastest is %s (%.2f ms)",
+             budgetMs, backends[best]->name(), bestMs);
+    }
+    LOGI("BackendAutotuner: Selected %s for %s", backends[best]->name(), key.c_str());
+
+    if (!cachePath.empty()) {
+        writeCache(cachePath, key, backends[best]->name(), bestMs);
+    }
+    return best;
+}
+
+float BackendAutotuner::measure(InterpolationBackend& backend) {
+    std::vector<float> times;
+
+    for (int run = 0; run < WARMUP_RUNS + TIMED_RUNS; run++) {
+        // Consecutive pairs of a stream, so per-frame caches behave as in a
+        // session (the earlier frame was the later one of the previous pair)
+        FrameData frame1 = frames_[run % 2];
+        FrameData frame2 = frames_[(run + 1) % 2];
+        frame1.frame_index = static_cast<uint64_t>(run);
+        frame2.frame_index = static_cast<uint64_t>(run) + 1;
+        frame2.timestamp_ns = frame1.timestamp_ns + 33'333'333;
+
+        FrameData output = frames_[2];
+        output.render_complete = VK_NULL_HANDLE;
+
+        auto startTime = Clock::now();
+        bool ok = backend.interpolate(frame1, frame2, 0.5f, output);
+
+        // Over budget still yields a frame; no completion semaphore means
+        // the backend failed outright
+        if (!ok && output.render_complete == VK_NULL_HANDLE) return -1.0f;
+
+        // Wait for the GPU side too — consumes the completion semaphore
+        if (output.render_complete != VK_NULL_HANDLE) {
+            if (!compute_->endComputeAndWait(compute_->beginCompute(), output.render_complete)) {
+                return -1.0f;
+            }
+        } else {
+            vkQueueWaitIdle(compute_->getComputeQueue());
+        }
+
+        if (run >= WARMUP_RUNS) {
+            times.push_back(std::chrono::duration<float, std::milli>(Clock::now() - startTime).count());
+        }
+    }
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+bool BackendAutotuner::createFrames(uint32_t width, uint32_t height) {
+    for (auto& frame : frames_) {
+        if (!createFrame(frame, width, height)) return false;
+    }
+    return uploadPattern(width, height);
+}
+
+bool BackendAutotuner::createFrame(FrameData& frame, uint32_t width, uint32_t height) {
+    VkDevice device = compute_->getDevice();
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                      VK_IMAGE_USAGE_SAMPLED_BIT |
+                      VK_IMAGE_USAGE_STORAGE_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &frame.image) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkMemoryRequirements memReq;
+    vkGetImageMemoryRequirements(device, frame.image, &memReq);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReq.size;
+    allocInfo.memoryTypeIndex = findDeviceLocalMemory(compute_->getPhysicalDevice(),
+                                                      memReq.memoryTypeBits);
+
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &frame.memory) != VK_SUCCESS) {
+        return false;
+    }
+    vkBindImageMemory(device, frame.image, frame.memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = frame.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &frame.image_view) != VK_SUCCESS) {
+        return false;
+    }
+
+    frame.width = width;
+    frame.height = height;
+    frame.format = imageInfo.format;
+    return true;
+}
+
+bool BackendAutotuner::uploadPattern(uint32_t width, uint32_t height) {
+    // Gradient + checkerboard, shifted horizontally in the second frame so
+    // motion-compensating backends do real work
+    VkDeviceSize frameBytes = static_cast<VkDeviceSize>(width) * height * 4;
+    GpuBuffer staging;
+    if (!staging.create(compute_->getDevice(), compute_->getPhysicalDevice(),
+                        frameBytes * 2, GpuBuffer::Type::STAGING)) {
+        return false;
+    }
+
+    auto* pixels = static_cast<uint8_t*>(staging.map());
+    if (!pixels) return false;
+    for (uint32_t f = 0; f < 2; f++) {
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                uint32_t sx = x + f * PATTERN_SHIFT;
+                uint8_t* p = pixels + f * frameBytes + (static_cast<size_t>(y) * width + x) * 4;
+                p[0] = static_cast<uint8_t>(sx * 255 / (width + PATTERN_SHIFT));
+                p[1] = static_cast<uint8_t>(y * 255 / height);
+                p[2] = ((sx / 16 + y / 16) & 1) ? 255 : 32;
+                p[3] = 255;
+            }
+        }
+    }
+    staging.unmap();
+
+    VkCommandBuffer cmd = compute_->beginCompute();
+    for (uint32_t f = 0; f < 2; f++) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = frames_[f].image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = f * frameBytes;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {width, height, 1};
+        vkCmdCopyBufferToImage(cmd, staging.buffer(), frames_[f].image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        // Inputs are sampled by the backends, like captured frames
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+    return compute_->endComputeAndWait(cmd);
+}
+
+void BackendAutotuner::destroyFrames() {
+    VkDevice device = compute_ ? compute_->getDevice() : VK_NULL_HANDLE;
+    if (device == VK_NULL_HANDLE) return;
+
+    vkQueueWaitIdle(compute_->getComputeQueue());
+    for (auto& frame : frames_) {
+        if (frame.image_view != VK_NULL_HANDLE)
+            vkDestroyImageView(device, frame.image_view, nullptr);
+        if (frame.image != VK_NULL_HANDLE)
+            vkDestroyImage(device, frame.image, nullptr);
+        if (frame.memory != VK_NULL_HANDLE)
+            vkFreeMemory(device, frame.memory, nullptr);
+        frame = FrameData{};
+    }
+}
+
+std::string BackendAutotuner::deviceKey(uint32_t width, uint32_t height) const {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(compute_->getPhysicalDevice(), &props);
+
+    char key[64];
+    snprintf(key, sizeof(key), "%04x:%04x:%08x:%ux%u",
+             props.vendorID, props.deviceID, props.driverVersion, width, height);
+    return key;
+}
+
+bool BackendAutotuner::readCache(const std::string& path, const std::string& key,
+                                 std::string& name) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string lineKey, lineName;
+        if (fields >> lineKey >> lineName && lineKey == key) {
+            name = lineName;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BackendAutotuner::writeCache(const std::string& path, const std::string& key,
+                                  const std::string& name, float ms) {
+    // One line per device/resolution: "<key> <backend> <ms>"
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, key.size() + 1, key + " ") != 0) lines.push_back(line);
+        }
+    }
+
+    char entry[128];
+    snprintf(entry, sizeof(entry), "%s %s %.2f", key.c_str(), name.c_str(), ms);
+    lines.push_back(entry);
+
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto& line : lines) file << line << '\n';
+    if (!file) {
+        LOGW("BackendAutotuner: Failed to write cache %s", path.c_str());
+    }
+}
+
+} // namespace framegen
@@ -0,0 +1,61 @@
+/**
+ * Backend Autotuner — picks the interpolation backend for this device.
+ *
+ * Times every prepared backend on synthetic frames (a textured pattern
+ * and a shifted copy) at the session's resolution. Backends that fit the
+ * per-frame budget are ranked by quality tier, then by time; if none
+ * fits, the fastest wins. The choice is cached in a small text file
+ * keyed by GPU vendor/device/driver and resolution, so later sessions on
+ * the same device skip the measurement.
+ */
+
+#pragma once
+
+#include "interpolation_backend.h"
+#include "../vulkan/vulkan_compute.h"
+#include <string>
+#include <vector>
+
+namespace framegen {
+
+class BackendAutotuner {
+public:
+    explicit BackendAutotuner(VulkanCompute* compute) : compute_(compute) {}
+    ~BackendAutotuner();
+
+    /**
+     * Prepares the candidates (only the cached one on a cache hit), times
+     * them and releases every backend but the choice.
+     * @param cachePath Cache file; empty disables caching
+     * @return Index into backends of the choice, or -1 if none ran
+     */
+    int select(const std::vector<InterpolationBackend*>& backends,
+               uint32_t width, uint32_t height, float budgetMs,
+               const std::string& cachePath);
+
+    static constexpr int WARMUP_RUNS = 2;
+    static constexpr int TIMED_RUNS = 8;
+    static constexpr int PATTERN_SHIFT = 6;   // Pixels of motion between the two frames
+
+private:
+    VulkanCompute* compute_ = nullptr;
+
+    // frames_[0..1] are inputs, frames_[2] the output
+    FrameData frames_[3];
+
+    bool createFrames(uint32_t width, uint32_t height);
+    bool createFrame(FrameData& frame, uint32_t width, uint32_t height);
+    bool uploadPattern(uint32_t width, uint32_t height);
+    void destroyFrames();
+
+    // Median wall time of one interpolate() including GPU completion,
+    // or a negative value if the backend failed
+    float measure(InterpolationBackend& backend);
+
+    std::string deviceKey(uint32_t width, uint32_t height) const;
+    static bool readCache(const std::string& path, const std::string& key, std::string& name);
+    static void writeCache(const std::string& path, const std::string& key,
+                           const std::string& name, float ms);
+};
+
+} // namespace framegen
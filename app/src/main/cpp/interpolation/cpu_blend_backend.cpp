@@ -0,0 +1,240 @@
+/**
+ * CPU Blend Backend implementation — readback, NEON blend, upload
+ */
+
+#include "cpu_blend_backend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace framegen {
+
+CpuBlendBackend::CpuBlendBackend(VulkanCompute* compute, const Config& config)
+    : compute_(compute), config_(config) {}
+
+bool CpuBlendBackend::prepare(uint32_t width, uint32_t height) {
+    if (!compute_) return false;
+
+    width_ = width;
+    height_ = height;
+
+    for (auto& buffer : readback_) {
+        buffer.destroy();
+        if (!buffer.create(compute_->getDevice(), compute_->getPhysicalDevice(),
+                           frameBytes(), GpuBuffer::Type::READBACK) || !buffer.map()) {
+            LOGE("CpuBlendBackend: Failed to create readback buffer");
+            return false;
+        }
+    }
+
+    // One slot until a pair asks for more
+    if (!createUpload(1)) return false;
+
+    LOGI("CpuBlendBackend: Prepared for %ux%u", width, height);
+    return true;
+}
+
+void CpuBlendBackend::release() {
+    for (auto& buffer : readback_) buffer.destroy();
+    upload_.destroy();
+    uploadSlots_ = 0;
+}
+
+bool CpuBlendBackend::createUpload(uint32_t slots) {
+    upload_.destroy();
+    uploadSlots_ = 0;
+    if (!upload_.create(compute_->getDevice(), compute_->getPhysicalDevice(),
+                        frameBytes() * slots, GpuBuffer::Type::STAGING) || !upload_.map()) {
+        LOGE("CpuBlendBackend: Failed to create upload buffer (%u frames)", slots);
+        return false;
+    }
+    uploadSlots_ = slots;
+    return true;
+}
+
+void CpuBlendBackend::recordImageCopy(VkCommandBuffer cmd, VkImage image, VkBuffer buffer,
+                                      bool toBuffer, VkDeviceSize bufferOffset) {
+    // Inputs are sampled (SHADER_READ_ONLY) by every other backend and are
+    // returned in that layout; the output ends in GENERAL like theirs
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    if (toBuffer) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    } else {
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;  // Fully overwritten
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = bufferOffset;
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {width_, height_, 1};
+
+    if (toBuffer) {
+        vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               buffer, 1, &region);
+    } else {
+        vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               1, &region);
+    }
+
+    barrier.srcAccessMask = toBuffer ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = barrier.newLayout;
+    barrier.newLayout = toBuffer ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                 : VK_IMAGE_LAYOUT_GENERAL;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    if (toBuffer) {
+        VkBufferMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = buffer;
+        hostBarrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+    }
+}
+
+bool CpuBlendBackend::readFrames(const FrameData& frame1, const FrameData& frame2) {
+    if (frame1.width != width_ || frame1.height != height_) {
+        LOGE("CpuBlendBackend: Frame does not match prepared size %ux%u", width_, height_);
+        return false;
+    }
+
+    VkCommandBuffer cmd = compute_->beginCompute();
+    recordImageCopy(cmd, frame1.image, readback_[0].buffer(), true);
+    recordImageCopy(cmd, frame2.image, readback_[1].buffer(), true);
+    if (!compute_->endComputeAndWait(cmd, frame2.render_complete)) {
+        LOGE("CpuBlendBackend: Readback failed");
+        return false;
+    }
+
+    readback_[0].invalidate();
+    readback_[1].invalidate();
+    return true;
+}
+
+void CpuBlendBackend::blendInto(const FrameData& frame1, const FrameData& frame2, float timestep,
+                                uint32_t slot, FrameData& output) {
+    VkDeviceSize offset = frameBytes() * slot;
+    uint32_t weight = static_cast<uint32_t>(std::lround(std::clamp(timestep, 0.0f, 1.0f) * 256.0f));
+    blend(static_cast<const uint8_t*>(readback_[0].map()),
+          static_cast<const uint8_t*>(readback_[1].map()),
+          static_cast<uint8_t*>(upload_.map()) + offset,
+          static_cast<size_t>(frameBytes()), weight);
+
+    // Host -> output image (coherent staging memory, no flush)
+    VkCommandBuffer cmd = compute_->beginCompute();
+    recordImageCopy(cmd, output.image, upload_.buffer(), false, offset);
+
+    output.render_complete = compute_->endComputeAndSubmit(cmd);
+    output.is_interpolated = true;
+    output.timestamp_ns = frame1.timestamp_ns +
+        static_cast<uint64_t>((frame2.timestamp_ns - frame1.timestamp_ns) * timestep);
+}
+
+bool CpuBlendBackend::interpolate(const FrameData& frame1, const FrameData& frame2,
+                                  float timestep, FrameData& output) {
+    auto startTime = Clock::now();
+
+    if (output.image == VK_NULL_HANDLE || !readFrames(frame1, frame2)) return false;
+    blendInto(frame1, frame2, timestep, 0, output);
+
+    lastMs_ = std::chrono::duration<float, std::milli>(Clock::now() - startTime).count();
+    return lastMs_ < ns_to_ms(config_.max_frame_time_ns);
+}
+
+bool CpuBlendBackend::interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                                    const float* timesteps, uint32_t count,
+                                    std::vector<FrameData>& outputs) {
+    outputs.resize(count);
+    if (count == 0) return true;
+    auto startTime = Clock::now();
+
+    for (const auto& output : outputs) {
+        if (output.image == VK_NULL_HANDLE) {
+            LOGE("CpuBlendBackend: No output image");
+            outputs.clear();
+            return false;
+        }
+    }
+
+    // frame2's semaphore is signalled once, so the pair is read back once.
+    // The readback's fence also covers earlier uploads on the queue, so
+    // the upload slots are free again from here.
+    if (!readFrames(frame1, frame2) ||
+        (count > uploadSlots_ && !createUpload(count))) {
+        outputs.clear();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        blendInto(frame1, frame2, timesteps[i], i, outputs[i]);
+    }
+
+    // All frames exist either way; the presenter drops late ones
+    float totalMs = std::chrono::duration<float, std::milli>(Clock::now() - startTime).count();
+    lastMs_ = totalMs / static_cast<float>(count);
+    if (lastMs_ >= ns_to_ms(config_.max_frame_time_ns)) {
+        LOGW("CpuBlendBackend: %u frames exceeded time budget (%.2f ms/frame)", count, lastMs_);
+    }
+    return true;
+}
+
+void CpuBlendBackend::blend(const uint8_t* a, const uint8_t* b, uint8_t* out,
+                            size_t bytes, uint32_t weight) {
+    if (weight == 0) {
+        std::memcpy(out, a, bytes);
+        return;
+    }
+    if (weight >= 256) {
+        std::memcpy(out, b, bytes);
+        return;
+    }
+
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    // 16 bytes per step: widen, weighted sum, round back to u8
+    uint8x8_t wa = vdup_n_u8(static_cast<uint8_t>(256 - weight));
+    uint8x8_t wb = vdup_n_u8(static_cast<uint8_t>(weight));
+    for (; i + 16 <= bytes; i += 16) {
+        uint8x16_t va = vld1q_u8(a + i);
+        uint8x16_t vb = vld1q_u8(b + i);
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(va), wa), vget_low_u8(vb), wb);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(va), wa), vget_high_u8(vb), wb);
+        vst1q_u8(out + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>((a[i] * (256 - weight) + b[i] * weight + 128) >> 8);
+    }
+}
+
+} // namespace framegen
@@ -0,0 +1,64 @@
+/**
+ * CPU Blend Backend — SIMD cross-fade on the CPU.
+ *
+ * Reads both frames back into host-visible staging buffers, blends them
+ * with NEON (scalar elsewhere) and uploads the result. No motion
+ * compensation, so it sits in the lowest quality tier; it wins only on
+ * devices whose GPU is the bottleneck (e.g. the game saturates it).
+ */
+
+#pragma once
+
+#include "interpolation_backend.h"
+#include "../vulkan/vulkan_compute.h"
+#include "../utils/gpu_buffer.h"
+
+namespace framegen {
+
+class CpuBlendBackend : public InterpolationBackend {
+public:
+    CpuBlendBackend(VulkanCompute* compute, const Config& config);
+    ~CpuBlendBackend() override = default;
+
+    const char* name() const override { return "cpu_blend"; }
+    int qualityTier() const override { return 0; }
+
+    bool prepare(uint32_t width, uint32_t height) override;
+    void release() override;
+    bool interpolate(const FrameData& frame1, const FrameData& frame2,
+                     float timestep, FrameData& output) override;
+    // One readback per pair, every timestep blended from it
+    bool interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                       const float* timesteps, uint32_t count,
+                       std::vector<FrameData>& outputs) override;
+    float getLastTimeMs() const override { return lastMs_; }
+
+    // out = a + (b - a) * weight / 256, weight in [0, 256]
+    static void blend(const uint8_t* a, const uint8_t* b, uint8_t* out,
+                      size_t bytes, uint32_t weight);
+
+private:
+    VulkanCompute* compute_ = nullptr;
+    Config config_;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    float lastMs_ = 0.0f;
+
+    GpuBuffer readback_[2];     // RGBA8 copies of frame1 / frame2
+    GpuBuffer upload_;          // Blended results, one frame per slot
+    uint32_t uploadSlots_ = 0;
+
+    VkDeviceSize frameBytes() const { return static_cast<VkDeviceSize>(width_) * height_ * 4; }
+    bool createUpload(uint32_t slots);
+
+    // Both frames -> readback_, waiting on frame2's capture semaphore
+    bool readFrames(const FrameData& frame1, const FrameData& frame2);
+    // Blend readback_ at timestep into upload slot `slot` and submit its copy
+    void blendInto(const FrameData& frame1, const FrameData& frame2, float timestep,
+                   uint32_t slot, FrameData& output);
+
+    void recordImageCopy(VkCommandBuffer cmd, VkImage image, VkBuffer buffer, bool toBuffer,
+                         VkDeviceSize bufferOffset = 0);
+};
+
+} // namespace framegen
@@ -0,0 +1,77 @@
+/**
+ * Interpolation Backend — one way of producing intermediate frames.
+ *
+ * RifeEngine owns a list of backends registered at runtime (NCNN RIFE,
+ * GPU compute warp/blend, CPU SIMD blend, ...) and routes every call to
+ * the one BackendAutotuner picked for this device and resolution.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <vector>
+
+namespace framegen {
+
+class InterpolationBackend {
+public:
+    virtual ~InterpolationBackend() = default;
+
+    // Stable identifier, used as the autotuner cache value
+    virtual const char* name() const = 0;
+
+    // Higher is better output. Among backends that fit the budget the
+    // autotuner prefers the highest tier, then the fastest.
+    virtual int qualityTier() const = 0;
+
+    /**
+     * Allocate resources for frames of the given size. A backend returning
+     * false is not considered.
+     */
+    virtual bool prepare(uint32_t width, uint32_t height) = 0;
+
+    // Free what prepare() allocated; called on backends that lost tuning
+    virtual void release() {}
+
+    /**
+     * Generate one frame between frame1 and frame2.
+     * @return true if interpolation succeeded within the time budget
+     */
+    virtual bool interpolate(const FrameData& frame1, const FrameData& frame2,
+                             float timestep, FrameData& output) = 0;
+
+    /**
+     * Generate one frame per timestep (ascending, each in (0,1)). The
+     * default runs interpolate() per timestep and truncates at the first
+     * one over budget.
+     */
+    virtual bool interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                               const float* timesteps, uint32_t count,
+                               std::vector<FrameData>& outputs) {
+        outputs.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            if (!interpolate(frame1, frame2, timesteps[i], outputs[i])) {
+                LOGW("%s: Interpolation %u/%u exceeded time budget", name(), i + 1, count);
+                // Truncate — return what we have
+                outputs.resize(i);
+                return i > 0;
+            }
+        }
+        return true;
+    }
+
+    // count evenly spaced frames (fixed N:1 cadence)
+    bool interpolateMulti(const FrameData& frame1, const FrameData& frame2,
+                          uint32_t count, std::vector<FrameData>& outputs) {
+        std::vector<float> timesteps(count);
+        for (uint32_t i = 0; i < count; i++) {
+            timesteps[i] = static_cast<float>(i + 1) / static_cast<float>(count + 1);
+        }
+        return interpolateAt(frame1, frame2, timesteps.data(), count, outputs);
+    }
+
+    // Duration of the last interpolate() (per frame for interpolateAt)
+    virtual float getLastTimeMs() const = 0;
+};
+
+} // namespace framegen
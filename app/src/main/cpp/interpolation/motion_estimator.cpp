@@ -3,6 +3,7 @@
  */
 
 #include "motion_estimator.h"
+#include <algorithm>
 
 namespace framegen {
 
@@ -14,41 +15,51 @@ bool MotionEstimator::init(VulkanCompute* compute, uint32_t width, uint32_t heig
     compute_ = compute;
     width_ = width;
     height_ = height;
+    pyramidLevels_ = std::max(pyramidLevels_, 2u);
+
+    // Compute pipelines for each stage (downsample, block matching,
+    // flow refinement); layouts come from the embedded shaders' reflection
+    for (const char* name : {"downsample", "block_match", "flow_refine"}) {
+        if (!compute_->createPipeline(name)) {
+            LOGE("MotionEstimator: Failed to create %s pipeline", name);
+            return false;
+        }
+    }
 
-    if (!createFlowField()) {
-        LOGE("MotionEstimator: Failed to create flow field");
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    if (vkCreateSampler(compute_->getDevice(), &samplerInfo, nullptr, &sampler_) != VK_SUCCESS) {
+        LOGE("MotionEstimator: Failed to create sampler");
         return false;
     }
 
+    for (Image& field : flow_) {
+        if (!createImage(field, VK_FORMAT_R16G16_SFLOAT, width_, height_,
+                         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)) {
+            LOGE("MotionEstimator: Failed to create flow field");
+            return false;
+        }
+    }
+
     if (!createPyramid()) {
         LOGE("MotionEstimator: Failed to create image pyramid");
         return false;
     }
 
-    // Setup compute pipelines for each stage
-    // 1. Downsample shader
-    std::vector<VkDescriptorSetLayoutBinding> downsampleBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-    };
-
-    // 2. Block matching shader
-    std::vector<VkDescriptorSetLayoutBinding> matchBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},  // prev level flow
-        {3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},            // output flow
-    };
-
-    // 3. Flow refinement shader
-    std::vector<VkDescriptorSetLayoutBinding> refineBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-    };
+    if (!createDescriptorSets() || !initLayouts()) {
+        LOGE("MotionEstimator: Failed to prepare descriptor sets");
+        return false;
+    }
 
     LOGI("MotionEstimator: Initialized %ux%u, %u pyramid levels, block=%u, search=%u",
-         width_, height_, pyramidLevels_, blockSize_, searchRadius_);
+         width_, height_, pyramidLevels_, BLOCK_SIZE, getSearchRadius());
     return true;
 }
 
@@ -58,38 +69,117 @@ void MotionEstimator::shutdown() {
     VkDevice dev = compute_->getDevice();
     vkDeviceWaitIdle(dev);
 
-    if (flowImageView_ != VK_NULL_HANDLE) vkDestroyImageView(dev, flowImageView_, nullptr);
-    if (flowImage_ != VK_NULL_HANDLE) vkDestroyImage(dev, flowImage_, nullptr);
-    if (flowMemory_ != VK_NULL_HANDLE) vkFreeMemory(dev, flowMemory_, nullptr);
-
+    freeDescriptorSets();
+    for (Image& field : flow_) destroyImage(field);
     destroyPyramid();
+
+    if (sampler_ != VK_NULL_HANDLE) {
+        vkDestroySampler(dev, sampler_, nullptr);
+        sampler_ = VK_NULL_HANDLE;
+    }
     compute_ = nullptr;
 }
 
+void MotionEstimator::recordBlitToLevel1(VkCommandBuffer cmd, const FrameData& frame,
+                                         uint32_t index) {
+    // Captures are kept SHADER_READ_ONLY; borrowed as a transfer source
+    VkImageMemoryBarrier toSrc{};
+    toSrc.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toSrc.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    toSrc.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toSrc.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    toSrc.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toSrc.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toSrc.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toSrc.image = frame.image;
+    toSrc.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toSrc);
+
+    const PyramidLevel& level = pyramid_[1];
+    VkImageBlit region{};
+    region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.srcOffsets[1] = {static_cast<int32_t>(frame.width),
+                            static_cast<int32_t>(frame.height), 1};
+    region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.dstOffsets[1] = {static_cast<int32_t>(level.width),
+                            static_cast<int32_t>(level.height), 1};
+    vkCmdBlitImage(cmd,
+        frame.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        level.frame[index].image, VK_IMAGE_LAYOUT_GENERAL,
+        1, &region, VK_FILTER_LINEAR);
+
+    VkImageMemoryBarrier toRead = toSrc;
+    toRead.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toRead.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    toRead.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toRead.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toRead);
+}
+
 float MotionEstimator::estimate(const FrameData& frame1, const FrameData& frame2,
-                                 VkImage flowOut, VkSemaphore waitSem) {
+                                 uint32_t slot, VkSemaphore waitSem) {
+    if (!compute_ || slot >= FLOW_SLOTS) return -1.0f;
+
+    std::lock_guard<std::mutex> lock(estimateMutex_);
     auto startTime = Clock::now();
 
     VkCommandBuffer cmd = compute_->beginCompute();
 
+    // Earlier submissions may still read the pyramid, or this flow slot
+    VkMemoryBarrier reuse{};
+    reuse.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    reuse.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    reuse.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &reuse, 0, nullptr, 0, nullptr);
+
     // ===== Stage 1: Build image pyramids =====
-    // Downsample both frames at each level
+    // Level 1 straight from the frames, then 2x2 box filter per level
+    recordBlitToLevel1(cmd, frame1, 0);
+    recordBlitToLevel1(cmd, frame2, 1);
+
+    VkMemoryBarrier blitDone{};
+    blitDone.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    blitDone.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    blitDone.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &blitDone, 0, nullptr, 0, nullptr);
+
     VkMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-    for (uint32_t level = 0; level < pyramidLevels_; level++) {
-        uint32_t lw = pyramid_[level].width;
-        uint32_t lh = pyramid_[level].height;
-
-        VulkanCompute::DispatchInfo downsampleInfo;
-        downsampleInfo.pipelineName = "downsample";
-        downsampleInfo.groupCountX = (lw + 15) / 16;
-        downsampleInfo.groupCountY = (lh + 15) / 16;
-        downsampleInfo.groupCountZ = 1;
-
-        compute_->dispatch(cmd, downsampleInfo);
+    for (uint32_t level = 2; level < pyramidLevels_; level++) {
+        struct DownsamplePushConstants {
+            uint32_t srcWidth;
+            uint32_t srcHeight;
+            uint32_t dstWidth;
+            uint32_t dstHeight;
+        } downsamplePC = {pyramid_[level - 1].width, pyramid_[level - 1].height,
+                          pyramid_[level].width, pyramid_[level].height};
+
+        for (uint32_t i = 0; i < 2; i++) {
+            VulkanCompute::DispatchInfo downsampleInfo;
+            downsampleInfo.pipelineName = "downsample";
+            downsampleInfo.groupCountX = (downsamplePC.dstWidth + 15) / 16;
+            downsampleInfo.groupCountY = (downsamplePC.dstHeight + 15) / 16;
+            downsampleInfo.groupCountZ = 1;
+            downsampleInfo.descriptorSets = {pyramid_[level].downsampleSets[i]};
+            downsampleInfo.pushConstants = &downsamplePC;
+            downsampleInfo.pushConstantSize = sizeof(downsamplePC);
+            compute_->dispatch(cmd, downsampleInfo);
+        }
 
         vkCmdPipelineBarrier(cmd,
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
@@ -98,8 +188,8 @@ float MotionEstimator::estimate(const FrameData& frame1, const FrameData& frame2
     }
 
     // ===== Stage 2: Coarse-to-fine block matching =====
-    // Start from the coarsest level and propagate upward
-    for (int level = static_cast<int>(pyramidLevels_) - 1; level >= 0; level--) {
+    // Start from the coarsest level and propagate down to level 1
+    for (uint32_t level = pyramidLevels_ - 1; level >= 1; level--) {
         uint32_t lw = pyramid_[level].width;
         uint32_t lh = pyramid_[level].height;
 
@@ -112,15 +202,18 @@ float MotionEstimator::estimate(const FrameData& frame1, const FrameData& frame2
             uint32_t totalLevels;
             float pad[2];
         } matchPC = {
-            lw, lh, blockSize_, searchRadius_,
-            static_cast<uint32_t>(level), pyramidLevels_, {0, 0}
+            lw, lh, BLOCK_SIZE, getSearchRadius(),
+            level, pyramidLevels_, {0, 0}
         };
 
         VulkanCompute::DispatchInfo matchInfo;
         matchInfo.pipelineName = "block_match";
-        matchInfo.groupCountX = (lw + blockSize_ - 1) / blockSize_;
-        matchInfo.groupCountY = (lh + blockSize_ - 1) / blockSize_;
+        uint32_t blocksX = (lw + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        uint32_t blocksY = (lh + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        matchInfo.groupCountX = (blocksX + MATCH_BLOCKS_X - 1) / MATCH_BLOCKS_X;
+        matchInfo.groupCountY = (blocksY + MATCH_BLOCKS_Y - 1) / MATCH_BLOCKS_Y;
         matchInfo.groupCountZ = 1;
+        matchInfo.descriptorSets = {pyramid_[level].matchSet};
         matchInfo.pushConstants = &matchPC;
         matchInfo.pushConstantSize = sizeof(matchPC);
 
@@ -132,49 +225,59 @@ float MotionEstimator::estimate(const FrameData& frame1, const FrameData& frame2
             0, 1, &barrier, 0, nullptr, 0, nullptr);
     }
 
-    // ===== Stage 3: Sub-pixel refinement at full resolution =====
+    // ===== Stage 3: Refinement, upsampled to full resolution =====
+    struct RefinePushConstants {
+        uint32_t width;
+        uint32_t height;
+        float edgeThreshold;
+        float flowScale;
+    } refinePC = {width_, height_, REFINE_EDGE_THRESHOLD, 2.0f};  // Level 1 -> full res
+
     VulkanCompute::DispatchInfo refineInfo;
     refineInfo.pipelineName = "flow_refine";
     refineInfo.groupCountX = (width_ + 15) / 16;
     refineInfo.groupCountY = (height_ + 15) / 16;
     refineInfo.groupCountZ = 1;
+    refineInfo.descriptorSets = {refineSets_[slot]};
+    refineInfo.pushConstants = &refinePC;
+    refineInfo.pushConstantSize = sizeof(refinePC);
 
     compute_->dispatch(cmd, refineInfo);
 
-    // Submit
+    // Submit; readers of the slot follow in queue order behind a barrier
     VkSemaphore doneSem = compute_->endComputeAndSubmit(cmd, waitSem);
     (void)doneSem;
 
     auto endTime = Clock::now();
     float elapsed = std::chrono::duration<float, std::milli>(endTime - startTime).count();
 
-    LOGD("MotionEstimator: %.2f ms (%u levels)", elapsed, pyramidLevels_);
+    LOGD("MotionEstimator: %.2f ms (%u levels, slot %u)", elapsed, pyramidLevels_, slot);
     return elapsed;
 }
 
-bool MotionEstimator::createFlowField() {
+bool MotionEstimator::createImage(Image& image, VkFormat format, uint32_t width, uint32_t height,
+                                  VkImageUsageFlags usage) {
     VkDevice dev = compute_->getDevice();
 
-    // RG16F format — 2 channels (dx, dy) in float16
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.format = VK_FORMAT_R16G16_SFLOAT;
-    imageInfo.extent = {width_, height_, 1};
+    imageInfo.format = format;
+    imageInfo.extent = {width, height, 1};
     imageInfo.mipLevels = 1;
     imageInfo.arrayLayers = 1;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.usage = usage;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    if (vkCreateImage(dev, &imageInfo, nullptr, &flowImage_) != VK_SUCCESS) {
+    if (vkCreateImage(dev, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
         return false;
     }
 
     VkMemoryRequirements memReq;
-    vkGetImageMemoryRequirements(dev, flowImage_, &memReq);
+    vkGetImageMemoryRequirements(dev, image.image, &memReq);
 
     VkMemoryAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -191,24 +294,32 @@ bool MotionEstimator::createFlowField() {
         }
     }
 
-    if (vkAllocateMemory(dev, &allocInfo, nullptr, &flowMemory_) != VK_SUCCESS) {
+    if (vkAllocateMemory(dev, &allocInfo, nullptr, &image.memory) != VK_SUCCESS) {
         return false;
     }
 
-    vkBindImageMemory(dev, flowImage_, flowMemory_, 0);
+    vkBindImageMemory(dev, image.image, image.memory, 0);
 
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = flowImage_;
+    viewInfo.image = image.image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R16G16_SFLOAT;
+    viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = 1;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
-    return vkCreateImageView(dev, &viewInfo, nullptr, &flowImageView_) == VK_SUCCESS;
+    return vkCreateImageView(dev, &viewInfo, nullptr, &image.view) == VK_SUCCESS;
+}
+
+void MotionEstimator::destroyImage(Image& image) {
+    VkDevice dev = compute_->getDevice();
+    if (image.view != VK_NULL_HANDLE) vkDestroyImageView(dev, image.view, nullptr);
+    if (image.image != VK_NULL_HANDLE) vkDestroyImage(dev, image.image, nullptr);
+    if (image.memory != VK_NULL_HANDLE) vkFreeMemory(dev, image.memory, nullptr);
+    image = Image{};
 }
 
 bool MotionEstimator::createPyramid() {
@@ -222,33 +333,129 @@ bool MotionEstimator::createPyramid() {
             w = (w + 1) / 2;
             h = (h + 1) / 2;
         }
-        pyramid_[i].width = w;
-        pyramid_[i].height = h;
-
-        // In a full implementation, create VkImage for each level
-        // For now we track dimensions
+        PyramidLevel& level = pyramid_[i];
+        level.width = w;
+        level.height = h;
         LOGD("Pyramid level %u: %ux%u", i, w, h);
+
+        // Level 0 is the captured frames themselves
+        if (i == 0) continue;
+
+        // Level 1 is a blit destination, the rest downsample outputs
+        VkImageUsageFlags frameUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                                       VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if (!createImage(level.frame[0], VK_FORMAT_R8G8B8A8_UNORM, w, h, frameUsage) ||
+            !createImage(level.frame[1], VK_FORMAT_R8G8B8A8_UNORM, w, h, frameUsage) ||
+            !createImage(level.flow, VK_FORMAT_R16G16_SFLOAT, w, h,
+                         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT)) {
+            return false;
+        }
     }
 
     return true;
 }
 
 void MotionEstimator::destroyPyramid() {
-    VkDevice dev = compute_ ? compute_->getDevice() : VK_NULL_HANDLE;
-    if (dev == VK_NULL_HANDLE) return;
+    if (!compute_) return;
 
     for (auto& level : pyramid_) {
-        if (level.view1 != VK_NULL_HANDLE) vkDestroyImageView(dev, level.view1, nullptr);
-        if (level.view2 != VK_NULL_HANDLE) vkDestroyImageView(dev, level.view2, nullptr);
-        if (level.flowView != VK_NULL_HANDLE) vkDestroyImageView(dev, level.flowView, nullptr);
-        if (level.image1 != VK_NULL_HANDLE) vkDestroyImage(dev, level.image1, nullptr);
-        if (level.image2 != VK_NULL_HANDLE) vkDestroyImage(dev, level.image2, nullptr);
-        if (level.flow != VK_NULL_HANDLE) vkDestroyImage(dev, level.flow, nullptr);
-        if (level.mem1 != VK_NULL_HANDLE) vkFreeMemory(dev, level.mem1, nullptr);
-        if (level.mem2 != VK_NULL_HANDLE) vkFreeMemory(dev, level.mem2, nullptr);
-        if (level.flowMem != VK_NULL_HANDLE) vkFreeMemory(dev, level.flowMem, nullptr);
+        destroyImage(level.frame[0]);
+        destroyImage(level.frame[1]);
+        destroyImage(level.flow);
     }
     pyramid_.clear();
 }
 
+bool MotionEstimator::createDescriptorSets() {
+    // Every binding is an owned image, so the sets never change after this
+    for (uint32_t l = 1; l < pyramidLevels_; l++) {
+        PyramidLevel& level = pyramid_[l];
+
+        if (l >= 2) {
+            for (uint32_t i = 0; i < 2; i++) {
+                VkDescriptorSet set = compute_->allocateDescriptorSet("downsample");
+                if (set == VK_NULL_HANDLE) return false;
+                compute_->updateDescriptorImage(set, 0, pyramid_[l - 1].frame[i].view, sampler_,
+                                                VK_IMAGE_LAYOUT_GENERAL);
+                compute_->updateDescriptorStorageImage(set, 1, level.frame[i].view);
+                level.downsampleSets[i] = set;
+            }
+        }
+
+        // The coarsest level has no coarser flow; its own is bound but
+        // never sampled (the shader checks the level)
+        const Image& coarser = l + 1 < pyramidLevels_ ? pyramid_[l + 1].flow : level.flow;
+        VkDescriptorSet set = compute_->allocateDescriptorSet("block_match");
+        if (set == VK_NULL_HANDLE) return false;
+        compute_->updateDescriptorImage(set, 0, level.frame[0].view, sampler_,
+                                        VK_IMAGE_LAYOUT_GENERAL);
+        compute_->updateDescriptorImage(set, 1, level.frame[1].view, sampler_,
+                                        VK_IMAGE_LAYOUT_GENERAL);
+        compute_->updateDescriptorImage(set, 2, coarser.view, sampler_, VK_IMAGE_LAYOUT_GENERAL);
+        compute_->updateDescriptorStorageImage(set, 3, level.flow.view);
+        level.matchSet = set;
+    }
+
+    // Edges of frame1 — the flow lives on its grid
+    for (uint32_t slot = 0; slot < FLOW_SLOTS; slot++) {
+        VkDescriptorSet set = compute_->allocateDescriptorSet("flow_refine");
+        if (set == VK_NULL_HANDLE) return false;
+        compute_->updateDescriptorImage(set, 0, pyramid_[1].flow.view, sampler_,
+                                        VK_IMAGE_LAYOUT_GENERAL);
+        compute_->updateDescriptorImage(set, 1, pyramid_[1].frame[0].view, sampler_,
+                                        VK_IMAGE_LAYOUT_GENERAL);
+        compute_->updateDescriptorStorageImage(set, 2, flow_[slot].view);
+        refineSets_[slot] = set;
+    }
+    return true;
+}
+
+void MotionEstimator::freeDescriptorSets() {
+    for (auto& level : pyramid_) {
+        for (auto& set : level.downsampleSets) {
+            compute_->freeDescriptorSet(set);
+            set = VK_NULL_HANDLE;
+        }
+        compute_->freeDescriptorSet(level.matchSet);
+        level.matchSet = VK_NULL_HANDLE;
+    }
+    for (auto& set : refineSets_) {
+        compute_->freeDescriptorSet(set);
+        set = VK_NULL_HANDLE;
+    }
+}
+
+bool MotionEstimator::initLayouts() {
+    std::vector<VkImageMemoryBarrier> barriers;
+    auto toGeneral = [&barriers](const Image& image) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barriers.push_back(barrier);
+    };
+
+    for (const Image& field : flow_) toGeneral(field);
+    for (uint32_t l = 1; l < pyramidLevels_; l++) {
+        toGeneral(pyramid_[l].frame[0]);
+        toGeneral(pyramid_[l].frame[1]);
+        toGeneral(pyramid_[l].flow);
+    }
+
+    VkCommandBuffer cmd = compute_->beginCompute();
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr,
+        static_cast<uint32_t>(barriers.size()), barriers.data());
+    return compute_->endComputeAndWait(cmd);
+}
+
 } // namespace framegen
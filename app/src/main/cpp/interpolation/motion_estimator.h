@@ -5,16 +5,22 @@
  * entirely on the GPU via Vulkan compute shaders.
  *
  * Algorithm:
- * 1. Build image pyramid (4 levels)
- * 2. Coarse-to-fine block matching at each level
- * 3. Refine motion vectors with sub-pixel accuracy
+ * 1. Build image pyramid (4 levels): both frames are blitted to half
+ *    resolution, then box-filtered down
+ * 2. Coarse-to-fine block matching from the coarsest level to level 1
+ * 3. Edge-aware refinement, upsampled into a full-resolution flow slot
  * 4. Output dense motion field for the interpolator
+ *
+ * Matching starts at half resolution so that every image the shaders
+ * bind is the estimator's own: all descriptor sets are written once at
+ * init, whatever capture image a frame lives in.
  */
 
 #pragma once
 
 #include "../framegen_types.h"
 #include "../vulkan/vulkan_compute.h"
+#include <mutex>
 #include <vector>
 
 namespace framegen {
@@ -29,56 +35,90 @@ public:
 
     /**
      * Estimate motion vectors between two frames.
-     * The output is a VkImage containing 2D motion vectors (RG16F format).
+     * The output is a VkImage containing 2D motion vectors (RG16F format),
+     * in full-resolution pixels on frame1's grid, left in GENERAL layout.
+     *
+     * Calls are serialized: the pyramid is scratch shared by every slot.
+     * Queue order keeps a later estimate from overwriting it early.
      *
-     * @param frame1   Source frame
+     * @param frame1   Source frame (SHADER_READ_ONLY, like every capture)
      * @param frame2   Target frame
-     * @param flowOut  Output image with motion vectors (dx, dy per pixel)
-     * @return Execution time in milliseconds
+     * @param slot     Flow slot written (getFlowImage(slot))
+     * @param waitSem  Semaphore to wait on before reading the frames
+     * @return Recording time in milliseconds (negative on failure)
      */
     float estimate(const FrameData& frame1, const FrameData& frame2,
-                   VkImage flowOut, VkSemaphore waitSem = VK_NULL_HANDLE);
+                   uint32_t slot, VkSemaphore waitSem = VK_NULL_HANDLE);
+
+    // Flow fields, so estimation of the next pair can run while the
+    // previous pair's field is still being read (slot = pair % FLOW_SLOTS)
+    static constexpr uint32_t FLOW_SLOTS = 4;
 
     // Get the motion vector image view for binding
-    VkImageView getFlowImageView() const { return flowImageView_; }
-    VkImage getFlowImage() const { return flowImage_; }
+    VkImageView getFlowImageView(uint32_t slot = 0) const { return flow_[slot].view; }
+    VkImage getFlowImage(uint32_t slot = 0) const { return flow_[slot].image; }
+
+    // block_match.comp tiles a group of blocks per workgroup (8x8 blocks,
+    // 4x2 per group) and shares the search apron through shared memory.
+    // The shader's tile layout is compiled for this block size, so it is
+    // not configurable.
+    static constexpr uint32_t BLOCK_SIZE = 8;
+    static constexpr uint32_t MATCH_BLOCKS_X = 4;
+    static constexpr uint32_t MATCH_BLOCKS_Y = 2;
 
     // Configuration
-    void setBlockSize(uint32_t size) { blockSize_ = size; }
-    void setSearchRadius(uint32_t radius) { searchRadius_ = radius; }
+    // The radius may change while another thread estimates
+    void setSearchRadius(uint32_t radius) { searchRadius_.store(radius, std::memory_order_relaxed); }
+    uint32_t getSearchRadius() const { return searchRadius_.load(std::memory_order_relaxed); }
+    // Call before init(); at least 2 (full resolution plus level 1)
     void setPyramidLevels(uint32_t levels) { pyramidLevels_ = levels; }
 
 private:
     VulkanCompute* compute_ = nullptr;
     uint32_t width_ = 0, height_ = 0;
-    uint32_t blockSize_ = 8;      // Block matching block size
-    uint32_t searchRadius_ = 16;  // Search area radius in pixels
+    std::atomic<uint32_t> searchRadius_{16};  // Search area radius in pixels
     uint32_t pyramidLevels_ = 4;  // Image pyramid depth
+    VkSampler sampler_ = VK_NULL_HANDLE;
+    std::mutex estimateMutex_;
+
+    // Edge-aware refinement: colour distance at which a neighbour's flow
+    // weighs e^-0.5 of the centre's
+    static constexpr float REFINE_EDGE_THRESHOLD = 0.1f;
+
+    // An image the estimator owns, kept in GENERAL for storage and sampling
+    struct Image {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+    };
 
-    // Flow field (RG16F = 2x float16 per pixel)
-    VkImage flowImage_ = VK_NULL_HANDLE;
-    VkImageView flowImageView_ = VK_NULL_HANDLE;
-    VkDeviceMemory flowMemory_ = VK_NULL_HANDLE;
+    // Flow fields (RG16F = 2x float16 per pixel)
+    Image flow_[FLOW_SLOTS];
+    VkDescriptorSet refineSets_[FLOW_SLOTS] = {};  // Level 1 flow -> flow_[slot]
 
-    // Image pyramid for multi-scale estimation
+    // Image pyramid for multi-scale estimation. Level 0 is the frames
+    // themselves and has no images of its own.
     struct PyramidLevel {
-        VkImage image1 = VK_NULL_HANDLE;
-        VkImage image2 = VK_NULL_HANDLE;
-        VkImageView view1 = VK_NULL_HANDLE;
-        VkImageView view2 = VK_NULL_HANDLE;
-        VkDeviceMemory mem1 = VK_NULL_HANDLE;
-        VkDeviceMemory mem2 = VK_NULL_HANDLE;
-        VkImage flow = VK_NULL_HANDLE;
-        VkImageView flowView = VK_NULL_HANDLE;
-        VkDeviceMemory flowMem = VK_NULL_HANDLE;
-        uint32_t width, height;
+        Image frame[2];                 // RGBA8 of frame1 / frame2
+        Image flow;                     // RG16F, in this level's pixels
+        VkDescriptorSet downsampleSets[2] = {};  // From level - 1 (level >= 2)
+        VkDescriptorSet matchSet = VK_NULL_HANDLE;
+        uint32_t width = 0, height = 0;
     };
 
     std::vector<PyramidLevel> pyramid_;
 
-    bool createFlowField();
+    bool createImage(Image& image, VkFormat format, uint32_t width, uint32_t height,
+                     VkImageUsageFlags usage);
+    void destroyImage(Image& image);
     bool createPyramid();
     void destroyPyramid();
+    bool createDescriptorSets();
+    void freeDescriptorSets();
+    // Every owned image UNDEFINED -> GENERAL, once
+    bool initLayouts();
+    // frame -> level 1 of pyramid image `index`, linear-filtered
+    void recordBlitToLevel1(VkCommandBuffer cmd, const FrameData& frame, uint32_t index);
 };
 
 } // namespace framegen
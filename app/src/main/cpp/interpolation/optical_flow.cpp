@@ -3,6 +3,7 @@
  */
 
 #include "optical_flow.h"
+#include "motion_estimator.h"
 
 namespace framegen {
 
@@ -22,6 +23,13 @@ bool OpticalFlow::init(VulkanCompute* compute, uint32_t width, uint32_t height)
     if (!createFlowImage(grayscale1_, VK_FORMAT_R16_SFLOAT, width, height)) return false;
     if (!createFlowImage(grayscale2_, VK_FORMAT_R16_SFLOAT, width, height)) return false;
 
+    for (const char* name : {"rgb_to_gray", "block_match", "flow_consistency"}) {
+        if (!compute_->createPipeline(name)) {
+            LOGE("OpticalFlow: Failed to create %s pipeline", name);
+            return false;
+        }
+    }
+
     LOGI("OpticalFlow: Initialized %ux%u bidirectional flow", width, height);
     return true;
 }
@@ -78,8 +86,10 @@ OpticalFlow::FlowResult OpticalFlow::computeBidirectional(
 
         VulkanCompute::DispatchInfo info;
         info.pipelineName = "block_match";
-        info.groupCountX = (width_ + 7) / 8;
-        info.groupCountY = (height_ + 7) / 8;
+        info.groupCountX = ((width_ + 7) / 8 + MotionEstimator::MATCH_BLOCKS_X - 1)
+                           / MotionEstimator::MATCH_BLOCKS_X;
+        info.groupCountY = ((height_ + 7) / 8 + MotionEstimator::MATCH_BLOCKS_Y - 1)
+                           / MotionEstimator::MATCH_BLOCKS_Y;
         info.groupCountZ = 1;
         info.pushConstants = &pc;
         info.pushConstantSize = sizeof(pc);
@@ -104,8 +114,10 @@ OpticalFlow::FlowResult OpticalFlow::computeBidirectional(
 
         VulkanCompute::DispatchInfo info;
         info.pipelineName = "block_match";
-        info.groupCountX = (width_ + 7) / 8;
-        info.groupCountY = (height_ + 7) / 8;
+        info.groupCountX = ((width_ + 7) / 8 + MotionEstimator::MATCH_BLOCKS_X - 1)
+                           / MotionEstimator::MATCH_BLOCKS_X;
+        info.groupCountY = ((height_ + 7) / 8 + MotionEstimator::MATCH_BLOCKS_Y - 1)
+                           / MotionEstimator::MATCH_BLOCKS_Y;
         info.groupCountZ = 1;
         info.pushConstants = &pc;
         info.pushConstantSize = sizeof(pc);
@@ -4,17 +4,146 @@
 
 #include "rife_engine.h"
 #include "motion_estimator.h"
+#include "backend_autotuner.h"
 #include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unistd.h>
 
 namespace framegen {
 
+// ============================================================
+// Backend adapters
+// ============================================================
+#if NCNN_ENABLED
+class RifeEngine::NcnnBackend : public InterpolationBackend {
+public:
+    explicit NcnnBackend(RifeEngine& engine) : engine_(engine) {}
+
+    const char* name() const override { return "ncnn_rife"; }
+    int qualityTier() const override { return 2; }
+
+    bool prepare(uint32_t width, uint32_t height) override {
+        return engine_.prepareLadder(width, height);
+    }
+    void release() override { engine_.releaseInterop(); }
+
+    bool interpolate(const FrameData& frame1, const FrameData& frame2,
+                     float timestep, FrameData& output) override {
+        return engine_.runNCNNInference(frame1, frame2, timestep, output);
+    }
+
+    bool interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                       const float* timesteps, uint32_t count,
+                       std::vector<FrameData>& outputs) override;
+
+    float getLastTimeMs() const override { return engine_.lastInferenceMs_; }
+
+private:
+    RifeEngine& engine_;
+};
+
+bool RifeEngine::NcnnBackend::interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                                            const float* timesteps, uint32_t count,
+                                            std::vector<FrameData>& outputs) {
+    outputs.resize(count);
+
+    // Batches of up to MAX_BATCH: one pre-pass and one NCNN submission
+    // each. The capture semaphore is signalled once per frame, so only the
+    // first batch waits on it; its pre-pass has completed by the second.
+    VkSemaphore waitSemaphore = frame2.render_complete;
+    for (uint32_t done = 0; done < count;) {
+        uint32_t batch = std::min(count - done, MAX_BATCH);
+        if (!engine_.runNCNNBatch(frame1, frame2, timesteps + done, batch,
+                                  outputs.data() + done, waitSemaphore)) {
+            // Retrying per timestep could wait on the consumed semaphore
+            LOGW("RifeEngine: Batched inference failed after %u/%u frames", done, count);
+            outputs.resize(done);
+            return done > 0;
+        }
+        waitSemaphore = VK_NULL_HANDLE;
+
+        // All frames exist either way; the presenter drops late ones
+        if (engine_.lastInferenceMs_ >= ns_to_ms(engine_.config_.max_frame_time_ns)) {
+            LOGW("RifeEngine: Batch of %u exceeded time budget (%.2f ms/frame)",
+                 batch, engine_.lastInferenceMs_);
+        }
+        done += batch;
+    }
+    return true;
+}
+#endif
+
+class RifeEngine::ComputeBackend : public InterpolationBackend {
+public:
+    explicit ComputeBackend(RifeEngine& engine) : engine_(engine) {}
+
+    const char* name() const override { return "gpu_warp_blend"; }
+    int qualityTier() const override { return 1; }
+
+    // Flow comes from the motion estimator; the warp images match the frames
+    bool prepare(uint32_t width, uint32_t height) override {
+        return engine_.motionEstimator_ && engine_.createWarpImages(width, height);
+    }
+    void release() override { engine_.destroyWarpImages(); }
+
+    bool interpolate(const FrameData& frame1, const FrameData& frame2,
+                     float timestep, FrameData& output) override {
+        if (!estimate(frame1, frame2) ||
+            !engine_.runWarpBlend(frame1, frame2, FLOW_SLOT, &timestep, 1, &output)) {
+            return false;
+        }
+        return engine_.lastInferenceMs_ < ns_to_ms(engine_.config_.max_frame_time_ns);
+    }
+
+    // The flow is estimated once per pair, and only that submission waits
+    // on the capture semaphore; queue order covers the warps
+    bool interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                       const float* timesteps, uint32_t count,
+                       std::vector<FrameData>& outputs) override {
+        outputs.resize(count);
+        if (count == 0) return true;
+        if (!estimate(frame1, frame2) ||
+            !engine_.runWarpBlend(frame1, frame2, FLOW_SLOT, timesteps, count, outputs.data())) {
+            outputs.clear();
+            return false;
+        }
+
+        // All frames exist either way; the presenter drops late ones
+        if (engine_.lastInferenceMs_ >= ns_to_ms(engine_.config_.max_frame_time_ns)) {
+            LOGW("%s: %u frames exceeded time budget (%.2f ms/frame)",
+                 name(), count, engine_.lastInferenceMs_);
+        }
+        return true;
+    }
+
+    float getLastTimeMs() const override { return engine_.lastInferenceMs_; }
+
+private:
+    RifeEngine& engine_;
+
+    // Flow slot these calls estimate into
+    static constexpr uint32_t FLOW_SLOT = 0;
+
+    bool estimate(const FrameData& frame1, const FrameData& frame2) {
+        return engine_.motionEstimator_->estimate(frame1, frame2, FLOW_SLOT,
+                                                  frame2.render_complete) >= 0.0f;
+    }
+};
+
 RifeEngine::~RifeEngine() {
     shutdown();
 }
 
-bool RifeEngine::init(const std::string& modelDir, VulkanCompute* compute, const Config& config) {
+bool RifeEngine::init(const std::string& modelDir, VulkanCompute* compute, const Config& config,
+                      const AssetBundle* bundle) {
     compute_ = compute;
+    bundle_ = bundle;
     config_ = config;
+    activeRung_ = nearestRung(config.model_scale);
 
     // Create linear sampler for texture sampling
     VkSamplerCreateInfo samplerInfo{};
@@ -31,48 +160,114 @@ bool RifeEngine::init(const std::string& modelDir, VulkanCompute* compute, const
         return false;
     }
 
+    // Every path that initializes becomes a backend; prepare() picks one
 #if NCNN_ENABLED
     if (initNCNN(modelDir)) {
         modelLoaded_ = true;
+        registerBackend(std::make_unique<NcnnBackend>(*this));
         LOGI("RifeEngine: NCNN RIFE model loaded successfully");
-        return true;
+    } else {
+        LOGW("RifeEngine: NCNN init failed — GPU compute path only");
     }
-    LOGW("RifeEngine: NCNN init failed, falling back to GPU compute");
 #endif
 
-    // Fallback to compute shader-based interpolation
+    // Compute shader-based interpolation
     if (initFallback()) {
+        auto backend = std::make_unique<ComputeBackend>(*this);
+        computeBackend_ = backend.get();
+        registerBackend(std::move(backend));
         LOGI("RifeEngine: GPU compute fallback initialized");
-        return true;
     }
 
-    LOGE("RifeEngine: All initialization methods failed");
-    return false;
+    if (backends_.empty()) {
+        LOGE("RifeEngine: All initialization methods failed");
+        return false;
+    }
+    return true;
+}
+
+void RifeEngine::registerBackend(std::unique_ptr<InterpolationBackend> backend) {
+    LOGI("RifeEngine: Registered backend %s", backend->name());
+    backends_.push_back(std::move(backend));
+}
+
+bool RifeEngine::prepare(uint32_t width, uint32_t height, const std::string& tuneCachePath) {
+    std::vector<InterpolationBackend*> candidates;
+    for (auto& backend : backends_) candidates.push_back(backend.get());
+
+    BackendAutotuner tuner(compute_);
+    int choice = tuner.select(candidates, width, height,
+                              ns_to_ms(config_.max_frame_time_ns), tuneCachePath);
+    if (choice < 0) {
+        LOGE("RifeEngine: No usable interpolation backend at %ux%u", width, height);
+        active_ = nullptr;
+        return false;
+    }
+
+    active_ = candidates[choice];
+    LOGI("RifeEngine: Interpolating with %s", active_->name());
+    return true;
 }
 
 void RifeEngine::shutdown() {
+    active_ = nullptr;
+    computeBackend_ = nullptr;
+    backends_.clear();
+
+    if (compute_) {
+        freeDescriptorCaches();
+        destroyWarpImages();
+    }
+    motionEstimator_ = nullptr;
+
     if (compute_ && linearSampler_ != VK_NULL_HANDLE) {
         vkDestroySampler(compute_->getDevice(), linearSampler_, nullptr);
         linearSampler_ = VK_NULL_HANDLE;
     }
 
-    for (auto& buf : scaledBuffers_) {
-        if (buf.view != VK_NULL_HANDLE)
-            vkDestroyImageView(compute_->getDevice(), buf.view, nullptr);
-        if (buf.image != VK_NULL_HANDLE)
-            vkDestroyImage(compute_->getDevice(), buf.image, nullptr);
-        if (buf.memory != VK_NULL_HANDLE)
-            vkFreeMemory(compute_->getDevice(), buf.memory, nullptr);
-    }
-    scaledBuffers_.clear();
-
 #if NCNN_ENABLED
+    releaseInterop();
     rifeNet_.clear();
+    rifeNetInt8_.clear();
+    net_ = &rifeNet_;
+    guardFrames_ = nullptr;
+    guardStorage_.clear();
+    guardPairs_ = 0;
 #endif
 
     modelLoaded_ = false;
 }
 
+static void recordOutputToGeneral(VkCommandBuffer cmd, VkImage image) {
+    VkImageMemoryBarrier toGeneral{};
+    toGeneral.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toGeneral.srcAccessMask = 0;
+    toGeneral.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    toGeneral.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;  // Fully overwritten
+    toGeneral.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    toGeneral.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toGeneral.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toGeneral.image = image;
+    toGeneral.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toGeneral);
+}
+
+// Earlier compute writes (tile composites, NCNN outputs, the flow field)
+// before the next read or read-modify-write of them
+static void recordComputeBarrier(VkCommandBuffer cmd) {
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
 #if NCNN_ENABLED
 bool RifeEngine::initNCNN(const std::string& modelDir) {
     // Initialize NCNN with Vulkan compute
@@ -84,9 +279,29 @@ bool RifeEngine::initNCNN(const std::string& modelDir) {
         return false;
     }
 
-    ncnnVkDevice_ = ncnn::get_gpu_device(0);
+    // Zero-copy needs NCNN on the engine's own VkDevice. A CPU round trip
+    // of every frame would blow the budget, so a separate device is refused.
+    ncnnVkDevice_ = nullptr;
+    for (int i = 0; i < gpuCount; i++) {
+        ncnn::VulkanDevice* vkdev = ncnn::get_gpu_device(i);
+        if (vkdev && vkdev->vkdevice() == compute_->getDevice()) {
+            ncnnVkDevice_ = vkdev;
+            break;
+        }
+    }
     if (!ncnnVkDevice_) {
-        LOGW("RifeEngine: Failed to get NCNN Vulkan device");
+        LOGW("RifeEngine: NCNN is not on the engine's VkDevice — no zero-copy path");
+        return false;
+    }
+    if (ncnnVkDevice_->info.compute_queue_family_index() != compute_->getComputeQueueFamily()) {
+        LOGW("RifeEngine: NCNN compute queue family differs from the engine's");
+        return false;
+    }
+
+    if (!compute_->createPipeline("rife_preprocess") ||
+        !compute_->createPipeline("rife_postprocess") ||
+        !compute_->createPipeline("rife_tile_postprocess")) {
+        LOGW("RifeEngine: Interop pipelines unavailable");
         return false;
     }
 
@@ -98,231 +313,1292 @@ bool RifeEngine::initNCNN(const std::string& modelDir) {
     rifeNet_.set_vulkan_device(ncnnVkDevice_);
 
     // Load RIFE model — expecting rife-v4.6-lite for mobile
-    std::string paramPath = modelDir + "/rife-v4.6-lite.param";
-    std::string binPath = modelDir + "/rife-v4.6-lite.bin";
+    if (!loadModel(rifeNet_, modelDir, "rife-v4.6-lite")) {
+        return false;
+    }
+
+    // Optional INT8 variant; prepareLadder benchmarks it against FP16
+    net_ = &rifeNet_;
+    precision_ = Precision::FP16;
+    rifeNetInt8_.opt = rifeNet_.opt;
+    rifeNetInt8_.opt.use_int8_inference = true;
+    rifeNetInt8_.opt.use_int8_storage = ncnnVkDevice_->info.support_int8_storage();
+    rifeNetInt8_.opt.use_int8_arithmetic = ncnnVkDevice_->info.support_int8_arithmetic();
+    rifeNetInt8_.set_vulkan_device(ncnnVkDevice_);
 
-    if (rifeNet_.load_param(paramPath.c_str()) != 0) {
+    bool haveInt8 = (bundle_ && bundle_->find("rife-v4.6-lite-int8.param")) ||
+                    access((modelDir + "/rife-v4.6-lite-int8.param").c_str(), R_OK) == 0;
+    if (haveInt8) {
+        if (!loadModel(rifeNetInt8_, modelDir, "rife-v4.6-lite-int8") || !loadGuardSet(modelDir)) {
+            LOGW("RifeEngine: INT8 model unusable — FP16 only");
+            rifeNetInt8_.clear();
+            haveInt8 = false;
+        }
+    }
+
+    stagingAllocator_ = ncnnVkDevice_->acquire_staging_allocator();
+
+    auto hasBlob = [this](const char* name) {
+        for (const auto& blob : rifeNet_.blobs()) {
+            if (blob.name == name) return true;
+        }
+        return false;
+    };
+    featureCaching_ = hasBlob(FEATURE_BLOBS[0]) && hasBlob(FEATURE_BLOBS[1]);
+
+    LOGI("RifeEngine: RIFE v4.6 lite model loaded (FP16%s, Vulkan, shared device)",
+         haveInt8 ? " + INT8 candidate" : "");
+    LOGI("RifeEngine: Encoder feature caching %s",
+         featureCaching_ ? "enabled" : "unavailable (model has no feature blobs)");
+    return true;
+}
+
+bool RifeEngine::loadModel(ncnn::Net& net, const std::string& modelDir,
+                           const std::string& modelName) {
+    const BundleEntry* paramEntry = bundle_ ? bundle_->find(modelName + ".param") : nullptr;
+    const BundleEntry* binEntry = bundle_ ? bundle_->find(modelName + ".bin") : nullptr;
+
+    if (paramEntry && binEntry) {
+        bundle_->prefetch(*binEntry);
+        if (!bundle_->verify(*paramEntry) || !bundle_->verify(*binEntry)) {
+            return false;
+        }
+
+        // Parsed and referenced in place: weights stay file-backed pages
+        // of the mapping rather than heap copies
+        const unsigned char* paramMem = bundle_->data(*paramEntry);
+        ncnn::DataReaderFromMemory paramReader(paramMem);
+        if (net.load_param(paramReader) != 0) {
+            LOGW("RifeEngine: Failed to load param from bundle: %s", paramEntry->name);
+            return false;
+        }
+
+        const unsigned char* binMem = bundle_->data(*binEntry);
+        ncnn::DataReaderFromMemory binReader(binMem);
+        if (net.load_model(binReader) != 0) {
+            LOGW("RifeEngine: Failed to load model from bundle: %s", binEntry->name);
+            return false;
+        }
+
+        LOGI("RifeEngine: %s loaded from bundle", modelName.c_str());
+        return true;
+    }
+
+    std::string paramPath = modelDir + "/" + modelName + ".param";
+    std::string binPath = modelDir + "/" + modelName + ".bin";
+
+    if (net.load_param(paramPath.c_str()) != 0) {
         LOGW("RifeEngine: Failed to load param: %s", paramPath.c_str());
         return false;
     }
 
-    if (rifeNet_.load_model(binPath.c_str()) != 0) {
+    if (net.load_model(binPath.c_str()) != 0) {
         LOGW("RifeEngine: Failed to load model: %s", binPath.c_str());
         return false;
     }
+    return true;
+}
+
+bool RifeEngine::loadGuardSet(const std::string& modelDir) {
+    static constexpr const char* GUARD_NAME = "rife-guard.rgb";
+    static constexpr uint32_t MAX_GUARD_DIM = 8192;
+
+    // Written by tools/calibrate_int8.py
+    struct GuardHeader {
+        char magic[4];      // "FGRG"
+        uint32_t width;
+        uint32_t height;
+        uint32_t pairCount;
+    } header;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    const BundleEntry* entry = bundle_ ? bundle_->find(GUARD_NAME) : nullptr;
+    if (entry) {
+        if (!bundle_->verify(*entry)) return false;
+        data = bundle_->data(*entry);
+        size = entry->size;
+    } else {
+        std::ifstream file(modelDir + "/" + GUARD_NAME, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            LOGW("RifeEngine: No INT8 guard set (%s)", GUARD_NAME);
+            return false;
+        }
+        guardStorage_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(guardStorage_.data()),
+                  static_cast<std::streamsize>(guardStorage_.size()));
+        data = guardStorage_.data();
+        size = guardStorage_.size();
+    }
+
+    if (size < sizeof(header)) {
+        LOGW("RifeEngine: Guard set truncated");
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    size_t frameBytes = static_cast<size_t>(header.width) * header.height * 3;
+    if (std::memcmp(header.magic, "FGRG", 4) != 0 ||
+        header.width == 0 || header.width > MAX_GUARD_DIM ||
+        header.height == 0 || header.height > MAX_GUARD_DIM || header.pairCount == 0 ||
+        (size - sizeof(header)) / (frameBytes * 2) < header.pairCount) {
+        LOGW("RifeEngine: Guard set malformed");
+        return false;
+    }
 
-    LOGI("RifeEngine: RIFE v4.6 lite model loaded (FP16, Vulkan)");
+    guardFrames_ = data + sizeof(header);
+    guardWidth_ = header.width;
+    guardHeight_ = header.height;
+    guardPairs_ = header.pairCount;
     return true;
 }
 
-bool RifeEngine::runNCNNInference(const FrameData& frame1, const FrameData& frame2,
-                                   float timestep, FrameData& output) {
-    auto startTime = Clock::now();
+float RifeEngine::benchmarkNet(ncnn::Net& net, const std::vector<ncnn::Mat>& inputs,
+                               std::vector<ncnn::Mat>& outputs) {
+    ncnn::Mat timestepMat(1);
+    timestepMat[0] = 0.5f;
+
+    // Both networks pay the same upload/download, so the comparison holds
+    uint32_t pairs = static_cast<uint32_t>(inputs.size() / 2);
+    outputs.assign(pairs, ncnn::Mat());
+    std::vector<float> times;
+
+    for (int run = 0; run <= BENCHMARK_RUNS; run++) {  // Run 0 warms up
+        auto startTime = Clock::now();
+        for (uint32_t i = 0; i < pairs; i++) {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.set_vulkan_compute(true);
+            ex.input("input0", inputs[i * 2]);
+            ex.input("input1", inputs[i * 2 + 1]);
+            ex.input("timestep", timestepMat);
+            if (ex.extract("output", outputs[i]) != 0) {
+                LOGE("RifeEngine: Benchmark extract failed");
+                return -1.0f;
+            }
+        }
+        if (run > 0) {
+            float ms = std::chrono::duration<float, std::milli>(Clock::now() - startTime).count();
+            times.push_back(ms / static_cast<float>(pairs));
+        }
+    }
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+float RifeEngine::psnr(const ncnn::Mat& a, const ncnn::Mat& b) {
+    if (a.w != b.w || a.h != b.h || a.c != b.c || a.empty()) return 0.0f;
+
+    double squaredError = 0.0;
+    size_t planeSize = static_cast<size_t>(a.w) * a.h;
+    for (int c = 0; c < a.c; c++) {
+        const float* pa = a.channel(c);
+        const float* pb = b.channel(c);
+        for (size_t i = 0; i < planeSize; i++) {
+            double d = std::clamp(pa[i], 0.0f, 1.0f) - std::clamp(pb[i], 0.0f, 1.0f);
+            squaredError += d * d;
+        }
+    }
+
+    // Peak signal is 1.0 — outputs are in [0,1]
+    double mse = squaredError / static_cast<double>(planeSize * a.c);
+    if (mse <= 0.0) return std::numeric_limits<float>::infinity();
+    return static_cast<float>(-10.0 * std::log10(mse));
+}
+
+void RifeEngine::selectPrecision(const Rung& rung) {
+    if (rifeNetInt8_.layers().empty() || guardPairs_ == 0) return;
+
+    // Guard pairs at the rung's resolution (one tile's worth when tiled),
+    // laid out like the pre-pass output
+    const float norm[3] = {1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f};
+    size_t frameBytes = static_cast<size_t>(guardWidth_) * guardHeight_ * 3;
+    uint32_t width = std::min(rung.width, rung.paddedWidth);
+    uint32_t height = std::min(rung.height, rung.paddedHeight);
+    std::vector<ncnn::Mat> inputs;
+    for (uint32_t i = 0; i < guardPairs_ * 2; i++) {
+        ncnn::Mat frame = ncnn::Mat::from_pixels_resize(
+            guardFrames_ + i * frameBytes, ncnn::Mat::PIXEL_RGB,
+            static_cast<int>(guardWidth_), static_cast<int>(guardHeight_),
+            static_cast<int>(width), static_cast<int>(height));
+        frame.substract_mean_normalize(nullptr, norm);
+
+        ncnn::Mat padded;
+        ncnn::copy_make_border(frame, padded,
+                               0, static_cast<int>(rung.paddedHeight - height),
+                               0, static_cast<int>(rung.paddedWidth - width),
+                               ncnn::BORDER_CONSTANT, 0.0f);
+        inputs.push_back(padded);
+    }
+
+    std::vector<ncnn::Mat> fp16Out;
+    std::vector<ncnn::Mat> int8Out;
+    float fp16Ms = benchmarkNet(rifeNet_, inputs, fp16Out);
+    float int8Ms = benchmarkNet(rifeNetInt8_, inputs, int8Out);
+
+    float minPsnr = 0.0f;
+    if (fp16Ms > 0.0f && int8Ms > 0.0f) {
+        minPsnr = std::numeric_limits<float>::infinity();
+        for (uint32_t i = 0; i < guardPairs_; i++) {
+            minPsnr = std::min(minPsnr, psnr(fp16Out[i], int8Out[i]));
+        }
+    }
+
+    bool faster = int8Ms > 0.0f && fp16Ms >= int8Ms * INT8_MIN_SPEEDUP;
+    bool accurate = minPsnr >= INT8_MIN_PSNR;
+    LOGI("RifeEngine: Precision benchmark at %ux%u: FP16 %.2f ms, INT8 %.2f ms, "
+         "INT8 PSNR %.1f dB (min over %u guard pairs)",
+         width, height, fp16Ms, int8Ms, minPsnr, guardPairs_);
+
+    // Only the chosen network stays resident
+    if (faster && accurate) {
+        net_ = &rifeNetInt8_;
+        precision_ = Precision::INT8;
+        rifeNet_.clear();
+        LOGI("RifeEngine: Using INT8");
+    } else {
+        rifeNetInt8_.clear();
+        LOGI("RifeEngine: Using FP16 (INT8 %s)", !faster ? "not faster" : "below PSNR guard");
+    }
+    guardFrames_ = nullptr;
+    guardStorage_.clear();
+    guardStorage_.shrink_to_fit();
+}
+
+void RifeEngine::releaseInterop() {
+    if (compute_ && compute_->getDevice() != VK_NULL_HANDLE) {
+        vkQueueWaitIdle(compute_->getComputeQueue());
+    }
+
+    for (auto& rung : ladder_) {
+        for (auto& blobs : rung.blobs) {
+            if (compute_) {
+                for (auto& sets : blobs.inputSets) {
+                    for (auto& [view, set] : sets) compute_->freeDescriptorSet(set);
+                    sets.clear();
+                }
+                for (auto& sets : blobs.outputSets) {
+                    for (auto& [view, set] : sets) compute_->freeDescriptorSet(set);
+                    sets.clear();
+                }
+            }
+
+            blobs.inputBlobs[0].release();
+            blobs.inputBlobs[1].release();
+            for (uint32_t i = 0; i < MAX_BATCH; i++) {
+                blobs.outputBlobs[i].release();
+                blobs.outputBlobBuffers[i] = VK_NULL_HANDLE;
+            }
+        }
+        for (auto& cached : rung.featureCache) {
+            cached.features.release();
+            cached.frameIndex = UINT64_MAX;
+        }
+
+        if (ncnnVkDevice_ && rung.blobAllocator) {
+            ncnnVkDevice_->reclaim_blob_allocator(rung.blobAllocator);
+        }
+        rung.blobAllocator = nullptr;
+    }
+
+    if (ncnnVkDevice_ && stagingAllocator_) {
+        ncnnVkDevice_->reclaim_staging_allocator(stagingAllocator_);
+    }
+    stagingAllocator_ = nullptr;
+}
+
+bool RifeEngine::createRung(Rung& rung) {
+    // A blob allocator per rung keeps each rung's workspace resident, so
+    // switching scale never frees and re-grows device memory
+    rung.blobAllocator = ncnnVkDevice_->acquire_blob_allocator();
+
+    for (uint32_t b = 0; b < rung.blobSets(); b++) {
+        for (auto& blob : rung.blobs[b].inputBlobs) {
+            blob.create(static_cast<int>(rung.paddedWidth), static_cast<int>(rung.paddedHeight), 3,
+                        sizeof(float), 1, rung.blobAllocator);
+            if (blob.empty()) {
+                LOGE("RifeEngine: Failed to allocate %ux%u input blob",
+                     rung.paddedWidth, rung.paddedHeight);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RifeEngine::warmRung(Rung& rung) {
+    // Zero the inputs so the dummy run sees defined data
+    VkCommandBuffer cmd = compute_->beginCompute();
+    for (uint32_t b = 0; b < rung.blobSets(); b++) {
+        for (const auto& blob : rung.blobs[b].inputBlobs) {
+            vkCmdFillBuffer(cmd, blob.buffer(), blob.buffer_offset(),
+                            blob.total() * blob.elemsize, 0);
+        }
+    }
+    if (!compute_->endComputeAndWait(cmd)) return false;
 
-    uint32_t w = static_cast<uint32_t>(frame1.width * config_.model_scale);
-    uint32_t h = static_cast<uint32_t>(frame1.height * config_.model_scale);
+    // A full batch in one submission grows the rung's workspace to what
+    // runNCNNBatch needs and creates every output slot (of both tile sets)
+    for (uint32_t b = 0; b < rung.blobSets(); b++) {
+        ncnn::VkCompute ncnnCmd(ncnnVkDevice_);
+        for (uint32_t i = 0; i < MAX_BATCH; i++) {
+            float t = static_cast<float>(i + 1) / static_cast<float>(MAX_BATCH + 1);
+            if (!runNetwork(rung, b, t, i, ncnnCmd)) return false;
+        }
+        if (ncnnCmd.submit_and_wait() != 0) return false;
 
-    // Pad to multiple of 32 (RIFE requirement)
-    uint32_t paddedW = (w + 31) / 32 * 32;
-    uint32_t paddedH = (h + 31) / 32 * 32;
+        for (uint32_t i = 0; i < MAX_BATCH; i++) {
+            rung.blobs[b].outputBlobBuffers[i] = rung.blobs[b].outputBlobs[i].buffer();
+        }
+    }
+    return true;
+}
 
-    // Create NCNN Mat from Vulkan images
-    // In production, we'd use ncnn::VkMat for zero-copy GPU<->NCNN transfer
-    ncnn::Mat in0(paddedW, paddedH, 3);
-    ncnn::Mat in1(paddedW, paddedH, 3);
+bool RifeEngine::runNetwork(Rung& rung, uint32_t b, float timestep, uint32_t slot,
+                            ncnn::VkCompute& cmd, const uint64_t* frameIndex) {
+    Rung::Blobs& blobs = rung.blobs[b];
     ncnn::Mat timestepMat(1);
     timestepMat[0] = timestep;
 
-    // Run inference
-    ncnn::Extractor ex = rifeNet_.create_extractor();
+    ncnn::Extractor ex = net_->create_extractor();
     ex.set_vulkan_compute(true);
+    ex.set_blob_vkallocator(rung.blobAllocator);
+    ex.set_workspace_vkallocator(rung.blobAllocator);
+    ex.set_staging_vkallocator(stagingAllocator_);
 
-    ex.input("input0", in0);
-    ex.input("input1", in1);
+    ex.input("input0", blobs.inputBlobs[0]);
+    ex.input("input1", blobs.inputBlobs[1]);
     ex.input("timestep", timestepMat);
 
-    ncnn::Mat outMat;
-    ex.extract("output", outMat);
+    // Reuse encoder features of frames seen in the previous pair — in a
+    // stream that is frame1 of this pair (and both frames for the later
+    // timesteps of the same pair)
+    bool useCache = featureCaching_ && frameIndex;
+    if (useCache) {
+        for (int i = 0; i < 2; i++) {
+            const ncnn::VkMat* cached = nullptr;
+            for (const auto& entry : rung.featureCache) {
+                if (entry.frameIndex == frameIndex[i] && !entry.features.empty()) {
+                    cached = &entry.features;
+                }
+            }
+            if (cached) {
+                ex.input(FEATURE_BLOBS[i], *cached);
+                featureHits_++;
+            } else {
+                featureMisses_++;
+            }
+        }
+    }
+
+    ncnn::VkMat outMat;
+    if (ex.extract("output", outMat, cmd) != 0) {
+        LOGE("RifeEngine: NCNN extract failed");
+        return false;
+    }
 
-    // Convert output back to VkImage
-    // The actual pixel copy would go through compute shaders
-    // to avoid expensive GPU<->CPU transfers
+    if (useCache) {
+        // Already computed (or fed in) for this run — no extra work
+        ncnn::VkMat features[2];
+        if (ex.extract(FEATURE_BLOBS[0], features[0], cmd) == 0 &&
+            ex.extract(FEATURE_BLOBS[1], features[1], cmd) == 0) {
+            for (int i = 0; i < 2; i++) {
+                rung.featureCache[i].frameIndex = frameIndex[i];
+                rung.featureCache[i].features = features[i];
+            }
+        }
+    }
 
-    auto endTime = Clock::now();
-    lastInferenceMs_ = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    // Unpack to fp32 elempack 1 so the post-pass has a fixed layout. Same
+    // shape and allocator every run, so each output slot keeps its buffer.
+    ncnn::Option unpackOpt = net_->opt;
+    unpackOpt.use_fp16_packed = false;
+    unpackOpt.use_fp16_storage = false;
+    unpackOpt.blob_vkallocator = rung.blobAllocator;
+    unpackOpt.staging_vkallocator = stagingAllocator_;
+    ncnnVkDevice_->convert_packing(outMat, blobs.outputBlobs[slot], 1, cmd, unpackOpt);
+    return true;
+}
 
-    LOGD("RifeEngine: NCNN inference: %.2f ms (budget: %.2f ms)",
-         lastInferenceMs_, ns_to_ms(config_.max_frame_time_ns));
+VkDescriptorSet RifeEngine::getInputSet(Rung& rung, uint32_t b, int slot, VkImageView view) {
+    Rung::Blobs& blobs = rung.blobs[b];
+    auto it = blobs.inputSets[slot].find(view);
+    if (it != blobs.inputSets[slot].end()) return it->second;
+
+    const ncnn::VkMat& blob = blobs.inputBlobs[slot];
+    VkDescriptorSet set = compute_->allocateDescriptorSet("rife_preprocess");
+    if (set == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    compute_->updateDescriptorImage(set, 0, view, linearSampler_);
+    compute_->updateDescriptorBuffer(set, 1, blob.buffer(),
+                                     blob.total() * blob.elemsize, blob.buffer_offset());
+    blobs.inputSets[slot][view] = set;
+    return set;
+}
+
+VkDescriptorSet RifeEngine::getOutputSet(Rung& rung, uint32_t b, uint32_t slot, VkImageView view) {
+    Rung::Blobs& blobs = rung.blobs[b];
+    const ncnn::VkMat& blob = blobs.outputBlobs[slot];
+    auto& sets = blobs.outputSets[slot];
+
+    // Output blobs are normally reused run to run; if NCNN handed back a
+    // different buffer, every cached set for this slot is stale
+    if (blob.buffer() != blobs.outputBlobBuffers[slot]) {
+        LOGW("RifeEngine: Output blob %u reallocated at %ux%u", slot, rung.width, rung.height);
+        vkQueueWaitIdle(compute_->getComputeQueue());
+        for (auto& [v, set] : sets) compute_->freeDescriptorSet(set);
+        sets.clear();
+        blobs.outputBlobBuffers[slot] = blob.buffer();
+    }
 
+    auto it = sets.find(view);
+    if (it != sets.end()) return it->second;
+
+    // Same bindings either way; a rung is tiled or not for its lifetime
+    VkDescriptorSet set = compute_->allocateDescriptorSet(
+        rung.tiled() ? "rife_tile_postprocess" : "rife_postprocess");
+    if (set == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    compute_->updateDescriptorBuffer(set, 0, blob.buffer(),
+                                     blob.total() * blob.elemsize, blob.buffer_offset());
+    compute_->updateDescriptorStorageImage(set, 1, view);
+    sets[view] = set;
+    return set;
+}
+
+bool RifeEngine::cacheSets(Rung& rung, uint32_t b, const FrameData* const frames[2],
+                           const FrameData* outputs, uint32_t count) {
+    for (int i = 0; frames && i < 2; i++) {
+        if (getInputSet(rung, b, i, frames[i]->image_view) == VK_NULL_HANDLE) return false;
+    }
+    for (uint32_t i = 0; outputs && i < count; i++) {
+        if (getOutputSet(rung, b, i, outputs[i].image_view) == VK_NULL_HANDLE) return false;
+    }
+    return true;
+}
+
+void RifeEngine::recordPrePass(VkCommandBuffer cmd, Rung& rung, uint32_t b,
+                               const FrameData* const frames[2], uint32_t originX, uint32_t originY) {
+    // Capture images -> input blobs (scale, normalize, pad; one tile when tiled)
+    struct PrePushConstants {
+        uint32_t width;
+        uint32_t height;
+        uint32_t paddedWidth;
+        uint32_t paddedHeight;
+        uint32_t cstep;
+        uint32_t originX;
+        uint32_t originY;
+        float pad;
+    } prePC = {rung.width, rung.height, rung.paddedWidth, rung.paddedHeight,
+               static_cast<uint32_t>(rung.blobs[b].inputBlobs[0].cstep), originX, originY, 0.0f};
+
+    for (int i = 0; i < 2; i++) {
+        VulkanCompute::DispatchInfo info;
+        info.pipelineName = "rife_preprocess";
+        info.groupCountX = (rung.paddedWidth + 15) / 16;
+        info.groupCountY = (rung.paddedHeight + 15) / 16;
+        info.groupCountZ = 1;
+        info.descriptorSets = {getInputSet(rung, b, i, frames[i]->image_view)};
+        info.pushConstants = &prePC;
+        info.pushConstantSize = sizeof(prePC);
+        compute_->dispatch(cmd, info);
+    }
+}
+
+void RifeEngine::recordTilePost(VkCommandBuffer cmd, Rung& rung, uint32_t b, uint32_t slot,
+                                uint32_t tile, const FrameData& output) {
+    TileSpan x = tileSpan(tile % rung.tilesX, rung.tilesX, rung.width, rung.paddedWidth);
+    TileSpan y = tileSpan(tile / rung.tilesX, rung.tilesY, rung.height, rung.paddedHeight);
+
+    // Output rect of the tile, one pixel of margin for the bilinear footprint
+    uint32_t x0 = x.origin * output.width / rung.width;
+    uint32_t y0 = y.origin * output.height / rung.height;
+    x0 = x0 > 0 ? x0 - 1 : 0;
+    y0 = y0 > 0 ? y0 - 1 : 0;
+    uint32_t x1 = std::min(output.width,
+        ((x.origin + x.size) * output.width + rung.width - 1) / rung.width + 1);
+    uint32_t y1 = std::min(output.height,
+        ((y.origin + y.size) * output.height + rung.height - 1) / rung.height + 1);
+
+    struct TilePushConstants {
+        uint32_t width;
+        uint32_t height;
+        uint32_t modelWidth;
+        uint32_t modelHeight;
+        uint32_t originX;
+        uint32_t originY;
+        uint32_t tileWidth;
+        uint32_t tileHeight;
+        uint32_t blobWidth;
+        uint32_t cstep;
+        uint32_t seamLeft;
+        uint32_t seamRight;
+        uint32_t seamTop;
+        uint32_t seamBottom;
+        uint32_t feather;
+        uint32_t outOffsetX;
+        uint32_t outOffsetY;
+    } tilePC = {output.width, output.height, rung.width, rung.height,
+                x.origin, y.origin, x.size, y.size, rung.paddedWidth,
+                static_cast<uint32_t>(rung.blobs[b].outputBlobs[slot].cstep),
+                x.seamBefore, x.seamAfter, y.seamBefore, y.seamAfter, rung.overlap, x0, y0};
+
+    VulkanCompute::DispatchInfo info;
+    info.pipelineName = "rife_tile_postprocess";
+    info.groupCountX = (x1 - x0 + 15) / 16;
+    info.groupCountY = (y1 - y0 + 15) / 16;
+    info.groupCountZ = 1;
+    info.descriptorSets = {getOutputSet(rung, b, slot, output.image_view)};
+    info.pushConstants = &tilePC;
+    info.pushConstantSize = sizeof(tilePC);
+    compute_->dispatch(cmd, info);
+}
+
+bool RifeEngine::runNCNNInference(const FrameData& frame1, const FrameData& frame2,
+                                   float timestep, FrameData& output) {
+    if (!runNCNNBatch(frame1, frame2, &timestep, 1, &output, frame2.render_complete)) {
+        return false;
+    }
     return lastInferenceMs_ < ns_to_ms(config_.max_frame_time_ns);
 }
+
+bool RifeEngine::runNCNNBatch(const FrameData& frame1, const FrameData& frame2,
+                              const float* timesteps, uint32_t count, FrameData* outputs,
+                              VkSemaphore waitSemaphore) {
+    auto startTime = Clock::now();
+
+    Rung& rung = ladder_[activeRung_];
+    if (rung.blobs[0].inputBlobs[0].empty()) {
+        LOGE("RifeEngine: Ladder not prepared");
+        return false;
+    }
+
+    if (rung.tiled()) {
+        if (!runTiledBatch(rung, frame1, frame2, timesteps, count, outputs, waitSemaphore)) {
+            return false;
+        }
+    } else {
+        // Step 1: capture images -> input blobs, once per pair
+        const FrameData* frames[2] = {&frame1, &frame2};
+        if (!cacheSets(rung, 0, frames, nullptr, 0)) return false;
+        VkCommandBuffer cmd = compute_->beginCompute();
+        recordPrePass(cmd, rung, 0, frames, 0, 0);
+
+        // NCNN records on its own queue of the same family; the blobs must be
+        // complete before it starts
+        if (!compute_->endComputeAndWait(cmd, waitSemaphore)) {
+            LOGE("RifeEngine: Pre-pass failed");
+            return false;
+        }
+
+        // Step 2: every timestep recorded into one NCNN submission. The first
+        // run fills the feature cache; the rest reuse it for both frames.
+        uint64_t frameIndex[2] = {frame1.frame_index, frame2.frame_index};
+        ncnn::VkCompute ncnnCmd(ncnnVkDevice_);
+        for (uint32_t i = 0; i < count; i++) {
+            if (!runNetwork(rung, 0, timesteps[i], i, ncnnCmd, frameIndex)) return false;
+        }
+
+        if (ncnnCmd.submit_and_wait() != 0) {
+            LOGE("RifeEngine: NCNN submit failed");
+            return false;
+        }
+
+        // Step 3: output blobs -> output images (upscale to full resolution).
+        // One submission per output so each gets its own completion semaphore.
+        if (!cacheSets(rung, 0, nullptr, outputs, count)) return false;
+        for (uint32_t i = 0; i < count; i++) {
+            FrameData& output = outputs[i];
+
+            struct PostPushConstants {
+                uint32_t width;
+                uint32_t height;
+                uint32_t modelWidth;
+                uint32_t modelHeight;
+                uint32_t paddedWidth;
+                uint32_t cstep;
+                float pad[2];
+            } postPC = {output.width, output.height, rung.width, rung.height, rung.paddedWidth,
+                        static_cast<uint32_t>(rung.blobs[0].outputBlobs[i].cstep), {}};
+
+            VkDescriptorSet outSet = getOutputSet(rung, 0, i, output.image_view);
+            cmd = compute_->beginCompute();
+            recordOutputToGeneral(cmd, output.image);
+
+            VulkanCompute::DispatchInfo postInfo;
+            postInfo.pipelineName = "rife_postprocess";
+            postInfo.groupCountX = (output.width + 15) / 16;
+            postInfo.groupCountY = (output.height + 15) / 16;
+            postInfo.groupCountZ = 1;
+            postInfo.descriptorSets = {outSet};
+            postInfo.pushConstants = &postPC;
+            postInfo.pushConstantSize = sizeof(postPC);
+            compute_->dispatch(cmd, postInfo);
+
+            output.render_complete = compute_->endComputeAndSubmit(cmd);
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        outputs[i].is_interpolated = true;
+        outputs[i].timestamp_ns = frame1.timestamp_ns +
+            static_cast<uint64_t>((frame2.timestamp_ns - frame1.timestamp_ns) * timesteps[i]);
+    }
+
+    // Reported per frame so it stays comparable with the single-step path
+    auto endTime = Clock::now();
+    float totalMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    lastInferenceMs_ = totalMs / static_cast<float>(count);
+
+    LOGD("RifeEngine: NCNN inference x%u: %.2f ms (budget: %.2f ms/frame, feature cache %" PRIu64 "/%" PRIu64 ")",
+         count, totalMs, ns_to_ms(config_.max_frame_time_ns),
+         featureHits_, featureHits_ + featureMisses_);
+    return true;
+}
+
+bool RifeEngine::runTiledBatch(Rung& rung, const FrameData& frame1, const FrameData& frame2,
+                               const float* timesteps, uint32_t count, FrameData* outputs,
+                               VkSemaphore waitSemaphore) {
+    const FrameData* frames[2] = {&frame1, &frame2};
+    uint32_t tiles = rung.tilesX * rung.tilesY;
+    auto originOf = [&](uint32_t tile, uint32_t& ox, uint32_t& oy) {
+        ox = tileSpan(tile % rung.tilesX, rung.tilesX, rung.width, rung.paddedWidth).origin;
+        oy = tileSpan(tile / rung.tilesX, rung.tilesY, rung.height, rung.paddedHeight).origin;
+    };
+
+    uint32_t ox, oy;
+    originOf(0, ox, oy);
+    if (!cacheSets(rung, 0, frames, nullptr, 0)) return false;
+    VkCommandBuffer cmd = compute_->beginCompute();
+    recordPrePass(cmd, rung, 0, frames, ox, oy);
+    if (!compute_->endComputeAndWait(cmd, waitSemaphore)) {
+        LOGE("RifeEngine: Pre-pass failed");
+        return false;
+    }
+
+    // Tile i runs on blob set i % 2. While NCNN works on it, the engine
+    // queue composites tile i - 1 and uploads tile i + 1 on the other set.
+    for (uint32_t tile = 0; tile < tiles; tile++) {
+        uint32_t b = tile % 2;
+
+        if (!cacheSets(rung, b ^ 1, tile + 1 < tiles ? frames : nullptr,
+                       tile > 0 ? outputs : nullptr, count)) {
+            return false;
+        }
+        cmd = compute_->beginCompute();
+        if (tile == 0) {
+            for (uint32_t i = 0; i < count; i++) recordOutputToGeneral(cmd, outputs[i].image);
+        } else {
+            recordComputeBarrier(cmd);
+            for (uint32_t i = 0; i < count; i++) {
+                recordTilePost(cmd, rung, b ^ 1, i, tile - 1, outputs[i]);
+            }
+        }
+        if (tile + 1 < tiles) {
+            originOf(tile + 1, ox, oy);
+            recordPrePass(cmd, rung, b ^ 1, frames, ox, oy);
+        }
+        VulkanCompute::Submission engineWork = compute_->endComputeAsync(cmd);
+
+        // Features are per tile, so the encoder cache is bypassed
+        ncnn::VkCompute ncnnCmd(ncnnVkDevice_);
+        bool ok = true;
+        for (uint32_t i = 0; i < count && ok; i++) {
+            ok = runNetwork(rung, b, timesteps[i], i, ncnnCmd);
+        }
+        ok = ok && ncnnCmd.submit_and_wait() == 0;
+
+        if (!compute_->waitSubmission(engineWork) || !ok) {
+            LOGE("RifeEngine: Tile %u/%u failed", tile + 1, tiles);
+            return false;
+        }
+    }
+
+    // Last tile — one submission per output for its completion semaphore
+    uint32_t last = tiles - 1;
+    if (!cacheSets(rung, last % 2, nullptr, outputs, count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        cmd = compute_->beginCompute();
+        recordComputeBarrier(cmd);
+        recordTilePost(cmd, rung, last % 2, i, last, outputs[i]);
+        outputs[i].render_complete = compute_->endComputeAndSubmit(cmd);
+    }
+    return true;
+}
 #endif
 
 // ============================================================
-// Fallback: GPU compute shader interpolation
+// Compute path: warp both frames along the flow, then blend
 // ============================================================
 bool RifeEngine::initFallback() {
     if (!compute_) return false;
 
-    // We use three compute shaders:
-    // 1. optical_flow.comp   — motion estimation between two frames
-    // 2. frame_warp.comp     — warp frame using motion vectors
-    // 3. frame_blend.comp    — blend warped frames for final output
-
-    // These would be loaded from SPIR-V at runtime
-    // For now, we set up the pipeline structure
-    
-    // Optical flow pipeline bindings
-    std::vector<VkDescriptorSetLayoutBinding> flowBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},  // flow output
-    };
-
-    // Frame warp pipeline bindings
-    std::vector<VkDescriptorSetLayoutBinding> warpBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},  // flow
-        {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},  // output
-    };
-
-    // Blend pipeline bindings
-    std::vector<VkDescriptorSetLayoutBinding> blendBindings = {
-        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-    };
+    // frame_warp — a frame warped along the motion estimator's flow
+    // frame_blend — the two warped frames blended into the output
+    // Layouts come from the embedded shaders' reflection data
+    for (const char* name : {"frame_warp", "frame_blend"}) {
+        if (!compute_->createPipeline(name)) {
+            LOGE("RifeEngine: Failed to create %s pipeline", name);
+            return false;
+        }
+    }
 
-    LOGI("RifeEngine: Fallback pipeline structure ready");
-    LOGI("RifeEngine: Load SPIR-V shaders from assets to complete initialization");
+    LOGI("RifeEngine: Fallback pipelines ready");
     return true;
 }
 
-bool RifeEngine::runFallbackInterpolation(const FrameData& frame1, const FrameData& frame2,
-                                            float timestep, FrameData& output) {
-    auto startTime = Clock::now();
+bool RifeEngine::createWarpImages(uint32_t width, uint32_t height) {
+    destroyWarpImages();
+    VkDevice dev = compute_->getDevice();
+
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(compute_->getPhysicalDevice(), &memProps);
+
+    for (auto& warped : warped_) {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+        imageInfo.extent = {width, height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(dev, &imageInfo, nullptr, &warped.image) != VK_SUCCESS) {
+            LOGE("RifeEngine: Failed to create warp image");
+            destroyWarpImages();
+            return false;
+        }
+
+        VkMemoryRequirements memReq;
+        vkGetImageMemoryRequirements(dev, warped.image, &memReq);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memReq.size;
+        allocInfo.memoryTypeIndex = 0;
+        for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+            if ((memReq.memoryTypeBits & (1 << i)) &&
+                (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+                allocInfo.memoryTypeIndex = i;
+                break;
+            }
+        }
+
+        if (vkAllocateMemory(dev, &allocInfo, nullptr, &warped.memory) != VK_SUCCESS) {
+            LOGE("RifeEngine: Failed to allocate warp image memory");
+            destroyWarpImages();
+            return false;
+        }
+        vkBindImageMemory(dev, warped.image, warped.memory, 0);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = warped.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = imageInfo.format;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        if (vkCreateImageView(dev, &viewInfo, nullptr, &warped.view) != VK_SUCCESS) {
+            LOGE("RifeEngine: Failed to create warp image view");
+            destroyWarpImages();
+            return false;
+        }
+    }
 
-    // Step 1: Compute optical flow (motion vectors) between frame1 and frame2
-    // This uses a multi-scale Lucas-Kanade approach on GPU
+    // Written as storage and sampled by the blend, so GENERAL for good
     VkCommandBuffer cmd = compute_->beginCompute();
+    for (auto& warped : warped_) recordOutputToGeneral(cmd, warped.image);
+    if (!compute_->endComputeAndWait(cmd)) {
+        destroyWarpImages();
+        return false;
+    }
+    return true;
+}
 
-    // Dispatch optical flow
-    VulkanCompute::DispatchInfo flowInfo;
-    flowInfo.pipelineName = "optical_flow";
-    flowInfo.groupCountX = (frame1.width + 15) / 16;
-    flowInfo.groupCountY = (frame1.height + 15) / 16;
-    flowInfo.groupCountZ = 1;
+void RifeEngine::destroyWarpImages() {
+    if (warped_[0].image == VK_NULL_HANDLE && warped_[1].image == VK_NULL_HANDLE) return;
 
-    struct FlowPushConstants {
-        float timestep;
-        uint32_t width;
-        uint32_t height;
-        uint32_t blockSize;
-    } flowPC = {timestep, frame1.width, frame1.height, 16};
+    // Sets naming the warp images go with them
+    vkQueueWaitIdle(compute_->getComputeQueue());
+    for (auto& [output, set] : blendSets_) compute_->freeDescriptorSet(set);
+    blendSets_.clear();
+    for (auto it = warpSets_.begin(); it != warpSets_.end();) {
+        VkImageView target = std::get<2>(it->first);
+        if (target == warped_[0].view || target == warped_[1].view) {
+            compute_->freeDescriptorSet(it->second);
+            it = warpSets_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    flowInfo.pushConstants = &flowPC;
-    flowInfo.pushConstantSize = sizeof(flowPC);
+    VkDevice dev = compute_->getDevice();
+    for (auto& warped : warped_) {
+        if (warped.view != VK_NULL_HANDLE) vkDestroyImageView(dev, warped.view, nullptr);
+        if (warped.image != VK_NULL_HANDLE) vkDestroyImage(dev, warped.image, nullptr);
+        if (warped.memory != VK_NULL_HANDLE) vkFreeMemory(dev, warped.memory, nullptr);
+        warped = WarpImage{};
+    }
+}
 
-    compute_->dispatch(cmd, flowInfo);
+VkDescriptorSet RifeEngine::getBlendSet(VkImageView output) {
+    auto it = blendSets_.find(output);
+    if (it != blendSets_.end()) return it->second;
 
-    // Memory barrier between flow and warp
-    VkMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(cmd,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        0, 1, &barrier, 0, nullptr, 0, nullptr);
+    VkDescriptorSet set = compute_->allocateDescriptorSet("frame_blend");
+    if (set == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    compute_->updateDescriptorImage(set, 0, warped_[0].view, linearSampler_,
+                                    VK_IMAGE_LAYOUT_GENERAL);
+    compute_->updateDescriptorImage(set, 1, warped_[1].view, linearSampler_,
+                                    VK_IMAGE_LAYOUT_GENERAL);
+    compute_->updateDescriptorStorageImage(set, 2, output);
+    blendSets_[output] = set;
+    return set;
+}
 
-    // Step 2: Warp both frames towards timestep
-    VulkanCompute::DispatchInfo warpInfo;
-    warpInfo.pipelineName = "frame_warp";
-    warpInfo.groupCountX = (frame1.width + 15) / 16;
-    warpInfo.groupCountY = (frame1.height + 15) / 16;
-    warpInfo.groupCountZ = 1;
-    compute_->dispatch(cmd, warpInfo);
+bool RifeEngine::runWarpBlend(const FrameData& frame1, const FrameData& frame2,
+                              uint32_t flowSlot, const float* timesteps, uint32_t count,
+                              FrameData* outputs) {
+    if (!motionEstimator_ || warped_[0].view == VK_NULL_HANDLE) {
+        LOGE("RifeEngine: Compute path not prepared");
+        return false;
+    }
 
-    vkCmdPipelineBarrier(cmd,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        0, 1, &barrier, 0, nullptr, 0, nullptr);
+    auto startTime = Clock::now();
+    flowSlot %= MotionEstimator::FLOW_SLOTS;
 
-    // Step 3: Blend warped frames
-    VulkanCompute::DispatchInfo blendInfo;
-    blendInfo.pipelineName = "frame_blend";
-    blendInfo.groupCountX = (frame1.width + 15) / 16;
-    blendInfo.groupCountY = (frame1.height + 15) / 16;
-    blendInfo.groupCountZ = 1;
+    // Sets first, so an exhausted pool fails before anything is submitted
+    const FrameData* sources[2] = {&frame1, &frame2};
+    VkDescriptorSet warpSets[2];
+    for (uint32_t f = 0; f < 2; f++) {
+        warpSets[f] = getWarpSet(sources[f]->image_view, flowSlot, warped_[f].view);
+        if (warpSets[f] == VK_NULL_HANDLE) return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (getBlendSet(outputs[i].image_view) == VK_NULL_HANDLE) return false;
+    }
 
+    uint64_t interval = frame2.timestamp_ns > frame1.timestamp_ns
+                        ? frame2.timestamp_ns - frame1.timestamp_ns : 0;
+    uint32_t groupsX = (frame1.width + 15) / 16;
+    uint32_t groupsY = (frame1.height + 15) / 16;
+
+    struct WarpPushConstants {
+        float timestep;
+        uint32_t width;
+        uint32_t height;
+        float direction;
+        float occlusionThreshold;
+    };
     struct BlendPushConstants {
         float blendFactor;
         uint32_t width;
         uint32_t height;
         float pad;
-    } blendPC = {timestep, frame1.width, frame1.height, 0.0f};
+    };
+
+    // One submission per output so each gets its own completion semaphore
+    for (uint32_t i = 0; i < count; i++) {
+        FrameData& output = outputs[i];
+        float t = timesteps[i];
+
+        // The flow is on frame1's grid: a pixel at t came from -t x flow in
+        // frame1 and lands at +(1 - t) x flow in frame2
+        WarpPushConstants warpPC[2] = {
+            {t, frame1.width, frame1.height, 1.0f, 0.0f},
+            {1.0f - t, frame1.width, frame1.height, -1.0f, 0.0f},
+        };
+        BlendPushConstants blendPC = {t, frame1.width, frame1.height, 0.0f};
+
+        VkCommandBuffer cmd = compute_->beginCompute();
+        // The estimate's flow writes, and the previous blend's reads of warped_
+        recordComputeBarrier(cmd);
+        recordOutputToGeneral(cmd, output.image);
+
+        for (uint32_t f = 0; f < 2; f++) {
+            VulkanCompute::DispatchInfo warpInfo;
+            warpInfo.pipelineName = "frame_warp";
+            warpInfo.groupCountX = groupsX;
+            warpInfo.groupCountY = groupsY;
+            warpInfo.groupCountZ = 1;
+            warpInfo.descriptorSets = {warpSets[f]};
+            warpInfo.pushConstants = &warpPC[f];
+            warpInfo.pushConstantSize = sizeof(WarpPushConstants);
+            compute_->dispatch(cmd, warpInfo);
+        }
 
-    blendInfo.pushConstants = &blendPC;
-    blendInfo.pushConstantSize = sizeof(blendPC);
-    compute_->dispatch(cmd, blendInfo);
+        recordComputeBarrier(cmd);
 
-    // Submit all and signal semaphore
-    VkSemaphore doneSem = compute_->endComputeAndSubmit(cmd, frame2.render_complete);
+        VulkanCompute::DispatchInfo blendInfo;
+        blendInfo.pipelineName = "frame_blend";
+        blendInfo.groupCountX = groupsX;
+        blendInfo.groupCountY = groupsY;
+        blendInfo.groupCountZ = 1;
+        blendInfo.descriptorSets = {getBlendSet(output.image_view)};
+        blendInfo.pushConstants = &blendPC;
+        blendInfo.pushConstantSize = sizeof(blendPC);
+        compute_->dispatch(cmd, blendInfo);
 
-    output.render_complete = doneSem;
-    output.is_interpolated = true;
-    output.timestamp_ns = (frame1.timestamp_ns + frame2.timestamp_ns) / 2;
+        output.render_complete = compute_->endComputeAndSubmit(cmd);
+        output.is_interpolated = true;
+        output.timestamp_ns = frame1.timestamp_ns +
+            static_cast<uint64_t>(static_cast<double>(interval) * t);
+    }
 
     auto endTime = Clock::now();
-    lastInferenceMs_ = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    lastInferenceMs_ = std::chrono::duration<float, std::milli>(endTime - startTime).count() / count;
+    return true;
+}
 
-    return lastInferenceMs_ < ns_to_ms(config_.max_frame_time_ns);
+bool RifeEngine::interpolateFromFlow(const FrameData& frame1, const FrameData& frame2,
+                                      uint32_t flowSlot, const float* timesteps, uint32_t count,
+                                      std::vector<FrameData>& outputs) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    outputs.resize(count);
+    if (count == 0) return true;
+    if (!estimatesFlow()) {
+        LOGE("RifeEngine: %s does not interpolate from estimated flow", getBackendName());
+        outputs.clear();
+        return false;
+    }
+
+    // estimateFlow() consumed frame2's semaphore; queue order covers these
+    if (!runWarpBlend(frame1, frame2, flowSlot, timesteps, count, outputs.data())) {
+        outputs.clear();
+        return false;
+    }
+
+    // All frames exist either way; the presenter drops late ones
+    if (lastInferenceMs_ >= ns_to_ms(config_.max_frame_time_ns)) {
+        LOGW("RifeEngine: %u frames exceeded time budget (%.2f ms/frame)",
+             count, lastInferenceMs_);
+    }
+    return true;
 }
 
-bool RifeEngine::interpolate(const FrameData& frame1, const FrameData& frame2,
-                              float timestep, FrameData& output) {
+// ============================================================
+// Extrapolation: warp the newest frame forward along its flow
+// ============================================================
+bool RifeEngine::setMotionEstimator(MotionEstimator* estimator) {
+    motionEstimator_ = estimator;
+    if (!estimator) return true;
+
+    // Normally built by initFallback already
+    if (!compute_ || !compute_->createPipeline("frame_warp")) {
+        LOGE("RifeEngine: No frame_warp pipeline for extrapolation");
+        motionEstimator_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool RifeEngine::reserveDescriptorSets(uint32_t captureImages, uint32_t outputImages) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    if (!compute_) return false;
+
+    // Sets cached so far may name warm-up and autotuning images, gone now
+    vkQueueWaitIdle(compute_->getComputeQueue());
+    freeDescriptorCaches();
+
+    // frame_warp: per capture image and flow slot, every pooled output
+    // (extrapolation) and both warp images (compute path); frame_blend:
+    // per pooled output
+    bool computePath = warped_[0].view != VK_NULL_HANDLE;
+    bool ok = true;
+    if (motionEstimator_) {
+        uint32_t targets = outputImages + (computePath ? 2 : 0);
+        ok = compute_->reserveDescriptorSets(
+            "frame_warp", captureImages * MotionEstimator::FLOW_SLOTS * targets);
+    }
+    if (computePath) {
+        ok = compute_->reserveDescriptorSets("frame_blend", outputImages) && ok;
+    }
+
 #if NCNN_ENABLED
-    if (modelLoaded_) {
-        return runNCNNInference(frame1, frame2, timestep, output);
+    // Per prepared rung and blob set: both inputs per ring image, every
+    // batch slot per pooled output
+    uint32_t inputSets = 0, outputSets = 0, tileOutputSets = 0;
+    for (const auto& rung : ladder_) {
+        if (rung.blobs[0].inputBlobs[0].empty()) continue;
+        inputSets += rung.blobSets() * 2 * captureImages;
+        (rung.tiled() ? tileOutputSets : outputSets) += rung.blobSets() * MAX_BATCH * outputImages;
+    }
+    if (inputSets > 0) {
+        ok = compute_->reserveDescriptorSets("rife_preprocess", inputSets) && ok;
+    }
+    if (outputSets > 0) {
+        ok = compute_->reserveDescriptorSets("rife_postprocess", outputSets) && ok;
+    }
+    if (tileOutputSets > 0) {
+        ok = compute_->reserveDescriptorSets("rife_tile_postprocess", tileOutputSets) && ok;
     }
 #endif
-    return runFallbackInterpolation(frame1, frame2, timestep, output);
+    return ok;
 }
 
-bool RifeEngine::interpolateMulti(const FrameData& frame1, const FrameData& frame2,
-                                   uint32_t count, std::vector<FrameData>& outputs) {
+void RifeEngine::freeDescriptorCaches() {
+    for (auto& [views, set] : warpSets_) compute_->freeDescriptorSet(set);
+    warpSets_.clear();
+    for (auto& [output, set] : blendSets_) compute_->freeDescriptorSet(set);
+    blendSets_.clear();
+
+#if NCNN_ENABLED
+    for (auto& rung : ladder_) {
+        for (auto& blobs : rung.blobs) {
+            for (auto& sets : blobs.inputSets) {
+                for (auto& [view, set] : sets) compute_->freeDescriptorSet(set);
+                sets.clear();
+            }
+            for (auto& sets : blobs.outputSets) {
+                for (auto& [view, set] : sets) compute_->freeDescriptorSet(set);
+                sets.clear();
+            }
+        }
+    }
+#endif
+}
+
+VkDescriptorSet RifeEngine::getWarpSet(VkImageView source, uint32_t flowSlot,
+                                       VkImageView output) {
+    auto key = std::make_tuple(source, flowSlot, output);
+    auto it = warpSets_.find(key);
+    if (it != warpSets_.end()) return it->second;
+
+    // The estimator's refine pass writes the slot as a storage image, GENERAL
+    VkDescriptorSet set = compute_->allocateDescriptorSet("frame_warp");
+    if (set == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    compute_->updateDescriptorImage(set, 0, source, linearSampler_);
+    compute_->updateDescriptorImage(set, 1, motionEstimator_->getFlowImageView(flowSlot),
+                                    linearSampler_, VK_IMAGE_LAYOUT_GENERAL);
+    compute_->updateDescriptorStorageImage(set, 2, output);
+    warpSets_[key] = set;
+    return set;
+}
+
+float RifeEngine::estimateFlow(const FrameData& previous, const FrameData& newest,
+                              uint32_t flowSlot) {
+    if (!motionEstimator_) {
+        LOGE("RifeEngine: Flow estimation needs a motion estimator");
+        return -1.0f;
+    }
+
+    // Forward flow previous -> newest; this submission consumes the newest
+    // frame's semaphore, and queue order covers the warps after it
+    flowSlot %= MotionEstimator::FLOW_SLOTS;
+    return motionEstimator_->estimate(previous, newest, flowSlot, newest.render_complete);
+}
+
+bool RifeEngine::extrapolate(const FrameData& previous, const FrameData& newest,
+                              uint32_t flowSlot, const float* timesteps, uint32_t count,
+                              std::vector<FrameData>& outputs) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
     outputs.resize(count);
+    if (count == 0) return true;
+    if (!motionEstimator_) {
+        LOGE("RifeEngine: Extrapolation needs a motion estimator");
+        return false;
+    }
+
+    auto startTime = Clock::now();
+    flowSlot %= MotionEstimator::FLOW_SLOTS;
+
+    uint64_t interval = newest.timestamp_ns > previous.timestamp_ns
+                        ? newest.timestamp_ns - previous.timestamp_ns : 0;
 
+    // Sets first, so an exhausted pool fails before anything is submitted
     for (uint32_t i = 0; i < count; i++) {
-        float t = static_cast<float>(i + 1) / static_cast<float>(count + 1);
-        if (!interpolate(frame1, frame2, t, outputs[i])) {
-            LOGW("RifeEngine: Interpolation %u/%u exceeded time budget", i + 1, count);
-            // Truncate — return what we have
-            outputs.resize(i);
-            return i > 0;
+        if (getWarpSet(newest.image_view, flowSlot, outputs[i].image_view) == VK_NULL_HANDLE) {
+            return false;
         }
     }
 
+    // One submission per output so each gets its own completion semaphore
+    for (uint32_t i = 0; i < count; i++) {
+        FrameData& output = outputs[i];
+
+        struct WarpPushConstants {
+            float timestep;
+            uint32_t width;
+            uint32_t height;
+            float direction;
+            float occlusionThreshold;
+        } warpPC = {timesteps[i], newest.width, newest.height, 1.0f,
+                    config_.extrapolation_occlusion_px};
+
+        VkCommandBuffer cmd = compute_->beginCompute();
+        recordComputeBarrier(cmd);
+        recordOutputToGeneral(cmd, output.image);
+
+        VulkanCompute::DispatchInfo info;
+        info.pipelineName = "frame_warp";
+        info.groupCountX = (newest.width + 15) / 16;
+        info.groupCountY = (newest.height + 15) / 16;
+        info.groupCountZ = 1;
+        info.descriptorSets = {getWarpSet(newest.image_view, flowSlot, output.image_view)};
+        info.pushConstants = &warpPC;
+        info.pushConstantSize = sizeof(warpPC);
+        compute_->dispatch(cmd, info);
+
+        output.render_complete = compute_->endComputeAndSubmit(cmd);
+        output.is_interpolated = true;
+        output.timestamp_ns = newest.timestamp_ns +
+            static_cast<uint64_t>(static_cast<double>(interval) * timesteps[i]);
+    }
+
+    auto endTime = Clock::now();
+    lastInferenceMs_ = std::chrono::duration<float, std::milli>(endTime - startTime).count() / count;
+    if (lastInferenceMs_ >= ns_to_ms(config_.max_frame_time_ns)) {
+        LOGW("RifeEngine: Extrapolation exceeded time budget (%.2f ms/frame)", lastInferenceMs_);
+    }
     return true;
 }
 
-void RifeEngine::setQuality(float quality) {
-    config_.quality = std::max(0.0f, std::min(1.0f, quality));
+bool RifeEngine::interpolate(const FrameData& frame1, const FrameData& frame2,
+                              float timestep, FrameData& output) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    if (!active_) {
+        LOGE("RifeEngine: No backend selected — call prepare()");
+        return false;
+    }
+    return active_->interpolate(frame1, frame2, timestep, output);
+}
 
-    // Adjust model scale based on quality
-    if (config_.quality < 0.3f) {
-        config_.model_scale = 0.25f;  // Quarter res — fastest
-    } else if (config_.quality < 0.6f) {
-        config_.model_scale = 0.5f;   // Half res — balanced
-    } else {
-        config_.model_scale = 0.75f;  // 3/4 res — high quality
+bool RifeEngine::interpolateMulti(const FrameData& frame1, const FrameData& frame2,
+                                   uint32_t count, std::vector<FrameData>& outputs) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    if (!active_) {
+        LOGE("RifeEngine: No backend selected — call prepare()");
+        outputs.clear();
+        return false;
+    }
+    return active_->interpolateMulti(frame1, frame2, count, outputs);
+}
+
+bool RifeEngine::interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                                const float* timesteps, uint32_t count,
+                                std::vector<FrameData>& outputs) {
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    if (!active_) {
+        LOGE("RifeEngine: No backend selected — call prepare()");
+        outputs.clear();
+        return false;
     }
+    return active_->interpolateAt(frame1, frame2, timesteps, count, outputs);
+}
+
+void RifeEngine::setQuality(float quality) {
+    // A rung switch like setModelScale(), held off the same way
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    config_.quality = std::clamp(quality, 0.0f, 1.0f);
+    activeRung_ = nearestRung(modelScaleForQuality(config_.quality));
+    config_.model_scale = SCALE_LADDER[activeRung_];
 
     LOGI("RifeEngine: Quality=%.2f, ModelScale=%.2f", config_.quality, config_.model_scale);
 }
 
 void RifeEngine::setModelScale(float scale) {
-    config_.model_scale = std::max(0.25f, std::min(1.0f, scale));
+    // Only rung switches — resources for every rung already exist. Held
+    // off while a synthesis is using the current rung.
+    std::lock_guard<std::mutex> lock(synthesisMutex_);
+    activeRung_ = nearestRung(scale);
+    config_.model_scale = SCALE_LADDER[activeRung_];
+}
+
+void RifeEngine::setSearchRadius(uint32_t radius) {
+    if (motionEstimator_) motionEstimator_->setSearchRadius(radius);
+}
+
+uint32_t RifeEngine::getSearchRadius() const {
+    return motionEstimator_ ? motionEstimator_->getSearchRadius() : 0;
+}
+
+size_t RifeEngine::nearestRung(float scale) {
+    size_t best = 0;
+    for (size_t i = 1; i < LADDER_RUNGS; i++) {
+        if (std::abs(SCALE_LADDER[i] - scale) < std::abs(SCALE_LADDER[best] - scale)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+uint32_t RifeEngine::tileCount(uint32_t extent, uint32_t tile, uint32_t overlap) {
+    if (tile == 0 || extent <= tile) return 1;
+    uint32_t step = tile - overlap;
+    return (extent - overlap + step - 1) / step;
+}
+
+RifeEngine::TileSpan RifeEngine::tileSpan(uint32_t index, uint32_t count, uint32_t extent,
+                                          uint32_t tile) {
+    if (count <= 1) return {0, extent, 0, 0};
+
+    // Even spacing rather than a fixed step with a clamped last tile: a
+    // clamped tile can overlap two predecessors, and the feathers of its
+    // seams would then no longer sum to 1
+    auto originOf = [&](uint32_t i) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(i) * (extent - tile) / (count - 1));
+    };
+
+    TileSpan span;
+    span.origin = originOf(index);
+    span.size = tile;
+    // Seams sit mid-overlap, as far from either tile's edge as possible
+    span.seamBefore = index > 0 ? (originOf(index - 1) + tile + span.origin) / 2 - span.origin : 0;
+    span.seamAfter = index + 1 < count ? (span.origin + tile + originOf(index + 1)) / 2 - span.origin : 0;
+    return span;
+}
+
+bool RifeEngine::prepareLadder(uint32_t width, uint32_t height) {
+    for (size_t i = 0; i < LADDER_RUNGS; i++) {
+        Rung& rung = ladder_[i];
+        rung.width = std::max(1u, static_cast<uint32_t>(width * SCALE_LADDER[i]));
+        rung.height = std::max(1u, static_cast<uint32_t>(height * SCALE_LADDER[i]));
+        rung.paddedWidth = (rung.width + 31) / 32 * 32;
+        rung.paddedHeight = (rung.height + 31) / 32 * 32;
+
+        // Tiles are square blobs; overlap capped at a quarter tile so the
+        // feathers of neighbouring seams never meet
+        uint32_t tile = config_.rife_tile_size / 32 * 32;
+        rung.overlap = tile ? std::clamp(config_.rife_tile_overlap, 2u, tile / 4) : 0;
+        rung.tilesX = tileCount(rung.width, tile, rung.overlap);
+        rung.tilesY = tileCount(rung.height, tile, rung.overlap);
+        if (rung.tilesX > 1) rung.paddedWidth = tile;
+        if (rung.tilesY > 1) rung.paddedHeight = tile;
+    }
+    activeRung_ = nearestRung(config_.model_scale);
+    config_.model_scale = SCALE_LADDER[activeRung_];
+
+#if NCNN_ENABLED
+    if (!modelLoaded_) return true;
+
+    // Decided once, at the resolution the engine starts at; every rung
+    // is then warmed with the chosen network
+    selectPrecision(ladder_[activeRung_]);
+
+    for (size_t i = 0; i < LADDER_RUNGS; i++) {
+        Rung& rung = ladder_[i];
+        auto startTime = Clock::now();
+
+        if (!createRung(rung) || !warmRung(rung)) {
+            LOGE("RifeEngine: Failed to prepare %.2fx rung", SCALE_LADDER[i]);
+            return false;
+        }
+
+        float ms = std::chrono::duration<float, std::milli>(Clock::now() - startTime).count();
+        LOGI("RifeEngine: Rung %.2fx ready (%ux%u, %s %ux%u, warm-up %.1f ms)",
+             SCALE_LADDER[i], rung.width, rung.height,
+             rung.tiled() ? "tiles" : "padded", rung.paddedWidth, rung.paddedHeight, ms);
+        if (rung.tiled()) {
+            LOGI("RifeEngine: Rung %.2fx runs %ux%u tiles, overlap >= %u",
+                 SCALE_LADDER[i], rung.tilesX, rung.tilesY, rung.overlap);
+        }
+    }
+#endif
+    return true;
 }
 
 } // namespace framegen
@@ -1,28 +1,52 @@
 /**
  * RIFE Engine — Real-Time Intermediate Flow Estimation
  *
- * Uses NCNN (Tencent) for neural network inference on mobile GPU.
- * Falls back to GPU compute optical flow when NCNN is not available.
+ * Uses NCNN (Tencent) for neural network inference on mobile GPU, next to
+ * a GPU compute path that warps both frames along MotionEstimator flow
+ * and blends them. Both are InterpolationBackends, as is anything added
+ * with registerBackend(); prepare() lets BackendAutotuner pick one for
+ * the device and resolution, and every call goes to it.
  *
  * The RIFE model predicts bidirectional optical flow between two frames
  * and uses it to synthesize an intermediate frame at any timestep t∈(0,1).
+ *
+ * NCNN must run on the same VkDevice as VulkanCompute: captured frames
+ * are converted into ncnn::VkMat input blobs by a compute pre-pass and
+ * the output blob is written into the output image by a post-pass, so
+ * frames never leave the GPU. On a separate device the NCNN path is
+ * refused and the compute fallback is used.
+ *
+ * When an INT8 model (tools/calibrate_int8.py) ships next to the FP16 one,
+ * both are benchmarked on the device at startup and INT8 is used only if
+ * it is faster and its output on the calibration guard set stays within
+ * INT8_MIN_PSNR of FP16.
  */
 
 #pragma once
 
 #include "../framegen_types.h"
 #include "../vulkan/vulkan_compute.h"
+#include "../utils/asset_bundle.h"
+#include "interpolation_backend.h"
 
 #if NCNN_ENABLED
 #include <net.h>
 #include <gpu.h>
+#include <command.h>
 #endif
 
+#include <array>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
+#include <unordered_map>
 
 namespace framegen {
 
+class MotionEstimator;
+
 class RifeEngine {
 public:
     RifeEngine() = default;
@@ -33,10 +57,25 @@ public:
      * @param modelDir Path to the NCNN model files (*.param, *.bin)
      * @param compute  VulkanCompute instance for GPU work
      * @param config   Engine configuration
+     * @param bundle   Mapped asset bundle; model entries found there are
+     *                 loaded in place instead of from modelDir. Must
+     *                 outlive the engine.
      */
-    bool init(const std::string& modelDir, VulkanCompute* compute, const Config& config);
+    bool init(const std::string& modelDir, VulkanCompute* compute, const Config& config,
+              const AssetBundle* bundle = nullptr);
     void shutdown();
 
+    // Add a backend for the autotuner to consider; call before prepare()
+    void registerBackend(std::unique_ptr<InterpolationBackend> backend);
+
+    /**
+     * Prepare every registered backend for frames of the given size and
+     * select one — cached per device and resolution in tuneCachePath
+     * (empty: always measure). Call once after init().
+     */
+    bool prepare(uint32_t width, uint32_t height, const std::string& tuneCachePath);
+    const char* getBackendName() const { return active_ ? active_->name() : "none"; }
+
     /**
      * Generate an interpolated frame between frame1 and frame2.
      *
@@ -56,47 +95,288 @@ public:
     bool interpolateMulti(const FrameData& frame1, const FrameData& frame2,
                           uint32_t count, std::vector<FrameData>& outputs);
 
+    /**
+     * Generate one frame per timestep (ascending, in (0,1)) — for cadences
+     * where the display slots do not divide the source interval evenly.
+     */
+    bool interpolateAt(const FrameData& frame1, const FrameData& frame2,
+                       const float* timesteps, uint32_t count,
+                       std::vector<FrameData>& outputs);
+
+    /**
+     * Motion estimation half of extrapolation, and of interpolation when
+     * estimatesFlow(): flow previous -> newest into MotionEstimator flow
+     * slot flowSlot. May run on another thread while a different slot's
+     * pair is being synthesized.
+     * @return Estimation time in ms (negative on failure)
+     */
+    float estimateFlow(const FrameData& previous, const FrameData& newest, uint32_t flowSlot);
+
+    // The selected backend interpolates from MotionEstimator flow, so a
+    // pipeline can estimate with estimateFlow() and synthesize with
+    // interpolateFromFlow() on separate threads
+    bool estimatesFlow() const { return active_ && active_ == computeBackend_; }
+
+    /**
+     * Synthesis half of interpolateAt() for the compute backend: warps
+     * frame1 and frame2 along the flow estimateFlow() left in flowSlot and
+     * blends them, one frame per timestep.
+     */
+    bool interpolateFromFlow(const FrameData& frame1, const FrameData& frame2, uint32_t flowSlot,
+                             const float* timesteps, uint32_t count,
+                             std::vector<FrameData>& outputs);
+
+    /**
+     * Predict frames past `newest` from the flow estimateFlow() left in
+     * flowSlot, for Config::extrapolation: timestep t lands at newest +
+     * t x (newest - previous). The newest frame is warped forward along
+     * the flow with frame_warp; disoccluded pixels keep the newest
+     * frame's own. Always the compute path, whatever backend interpolates.
+     */
+    bool extrapolate(const FrameData& previous, const FrameData& newest, uint32_t flowSlot,
+                     const float* timesteps, uint32_t count,
+                     std::vector<FrameData>& outputs);
+
+    // Flow source for extrapolate() and the compute backend; must outlive
+    // the engine. Before prepare(), or the compute backend is skipped.
+    bool setMotionEstimator(MotionEstimator* estimator);
+    bool canExtrapolate() const { return motionEstimator_ != nullptr; }
+
+    /**
+     * Give the descriptor caches keyed by image views pools sized for the
+     * images frames come from: captureImages ring images in, outputImages
+     * pooled images out. Drops sets cached for warm-up and autotuning
+     * images. After prepare() and setMotionEstimator(), before frames flow.
+     */
+    bool reserveDescriptorSets(uint32_t captureImages, uint32_t outputImages);
+
     // Performance
-    float getLastInferenceTimeMs() const { return lastInferenceMs_; }
+    float getLastInferenceTimeMs() const {
+        return active_ ? active_->getLastTimeMs() : lastInferenceMs_;
+    }
     bool isModelLoaded() const { return modelLoaded_; }
 
     // Quality control
-    void setQuality(float quality); // 0.0-1.0
-    void setModelScale(float scale); // Resolution scaling
+    void setQuality(float quality); // 0.0-1.0, to the rung modelScaleForQuality() picks
+    void setModelScale(float scale); // Resolution scaling, snapped to the ladder
+    float getModelScale() const { return SCALE_LADDER[activeRung_]; }
+
+    // Block-match radius of the extrapolation flow (0 without an estimator)
+    void setSearchRadius(uint32_t radius);
+    uint32_t getSearchRadius() const;
+
+    enum class Precision { FP16, INT8 };
+    Precision getPrecision() const { return precision_; }
+
+    // Timesteps per NCNN submission (FPS_120); longer plans run in batches
+    static constexpr uint32_t MAX_BATCH = 3;
+
+    // Model scales with pre-allocated resources
+    static constexpr size_t LADDER_RUNGS = MODEL_SCALE_RUNGS;
+    static constexpr const auto& SCALE_LADDER = MODEL_SCALE_LADDER;
 
 private:
     VulkanCompute* compute_ = nullptr;
+    const AssetBundle* bundle_ = nullptr;
     Config config_;
     bool modelLoaded_ = false;
     float lastInferenceMs_ = 0.0f;
+    Precision precision_ = Precision::FP16;
+
+    // Registered backends and the one selected by prepare()
+    std::vector<std::unique_ptr<InterpolationBackend>> backends_;
+    InterpolationBackend* active_ = nullptr;
+    InterpolationBackend* computeBackend_ = nullptr;  // Registered by init(), if any
+
+    // Adapters exposing the engine's own paths as backends
+    class NcnnBackend;
+    class ComputeBackend;
+
+    // One rung of the model-scale ladder: everything inference needs at
+    // that scale. The pre-pass samples captured frames straight into the
+    // rung's input blobs, so they double as its scaled frame buffers.
+    //
+    // A rung larger than Config::rife_tile_size in either dimension is
+    // tiled: the blobs hold one tile (paddedWidth x paddedHeight) and the
+    // frame is covered by tilesX x tilesY tiles overlapping by at least
+    // `overlap`, so blob memory is bounded by the tile size.
+    struct Rung {
+        uint32_t width = 0;         // Model resolution
+        uint32_t height = 0;
+        uint32_t paddedWidth = 0;   // Blob resolution, multiple of 32 (RIFE requirement)
+        uint32_t paddedHeight = 0;
+        uint32_t tilesX = 1;
+        uint32_t tilesY = 1;
+        uint32_t overlap = 0;
+        bool tiled() const { return tilesX * tilesY > 1; }
+#if NCNN_ENABLED
+        ncnn::VkAllocator* blobAllocator = nullptr;  // Holds this rung's workspace
+
+        struct Blobs {
+            ncnn::VkMat inputBlobs[2];  // fp32 CHW, elempack 1
+            // Network output converted to fp32 elempack 1, one per batch slot
+            ncnn::VkMat outputBlobs[MAX_BATCH];
+            VkBuffer outputBlobBuffers[MAX_BATCH] = {};
+
+            // Descriptor sets per capture/output image view (ring-sized)
+            std::unordered_map<VkImageView, VkDescriptorSet> inputSets[2];
+            std::unordered_map<VkImageView, VkDescriptorSet> outputSets[MAX_BATCH];
+        };
+        // Tiled rungs double-buffer: the next tile is uploaded and the
+        // previous one composited while NCNN runs the current one
+        Blobs blobs[2];
+        uint32_t blobSets() const { return tiled() ? 2 : 1; }
+
+        // Encoder features of the last pair, keyed by FrameData::frame_index
+        struct CachedFeatures {
+            uint64_t frameIndex = UINT64_MAX;
+            ncnn::VkMat features;
+        } featureCache[2];
+#endif
+    };
+
+    std::array<Rung, LADDER_RUNGS> ladder_;
+    size_t activeRung_ = 1;
+
+    static size_t nearestRung(float scale);
+
+    // Tile grid along one axis of `extent` model pixels. Origins are
+    // spread evenly, so every overlap is at least the configured one.
+    struct TileSpan {
+        uint32_t origin;        // First model pixel covered
+        uint32_t size;          // Valid pixels (<= tile)
+        uint32_t seamBefore;    // Tile-local seam with the previous tile, 0 at the frame edge
+        uint32_t seamAfter;     // ... and with the next one
+    };
+    static uint32_t tileCount(uint32_t extent, uint32_t tile, uint32_t overlap);
+    static TileSpan tileSpan(uint32_t index, uint32_t count, uint32_t extent, uint32_t tile);
+
+    /**
+     * Allocate and warm every rung of the model-scale ladder for frames of
+     * the given size (one dummy inference each), so later scale changes
+     * only switch rungs.
+     */
+    bool prepareLadder(uint32_t width, uint32_t height);
 
 #if NCNN_ENABLED
     // NCNN network for RIFE inference
     ncnn::Net rifeNet_;
+    ncnn::Net rifeNetInt8_;             // Loaded only when an INT8 model ships
+    ncnn::Net* net_ = &rifeNet_;        // Network picked by selectPrecision
     ncnn::VulkanDevice* ncnnVkDevice_ = nullptr;
 
     bool initNCNN(const std::string& modelDir);
+    bool loadModel(ncnn::Net& net, const std::string& modelDir, const std::string& modelName);
     bool runNCNNInference(const FrameData& frame1, const FrameData& frame2,
                           float timestep, FrameData& output);
+
+    // Up to MAX_BATCH timesteps of a pair in one pre-pass and one NCNN
+    // submission. The pre-pass waits on waitSemaphore — the capture's, on
+    // the first batch of a pair only, since it is signalled once. Returns
+    // false only on failure — the budget is checked by the caller against
+    // lastInferenceMs_ (per frame).
+    bool runNCNNBatch(const FrameData& frame1, const FrameData& frame2,
+                      const float* timesteps, uint32_t count, FrameData* outputs,
+                      VkSemaphore waitSemaphore);
+
+    // Zero-copy interop — blobs live on the shared VkDevice, per rung
+    ncnn::VkAllocator* stagingAllocator_ = nullptr;
+
+    // Split execution: the per-frame encoder outputs are named blobs. A
+    // cached blob is fed back with Extractor::input, and NCNN then skips
+    // the layers that would have produced it.
+    static constexpr const char* FEATURE_BLOBS[2] = {"feat0", "feat1"};
+    bool featureCaching_ = false;   // Model exposes both FEATURE_BLOBS
+    uint64_t featureHits_ = 0;
+    uint64_t featureMisses_ = 0;
+
+    // Records one inference into cmd, reading and writing blob set b.
+    // frameIndex: frame_index of the two inputs, or nullptr to bypass the
+    // cache (always for tiles — features are per tile)
+    bool runNetwork(Rung& rung, uint32_t b, float timestep, uint32_t slot, ncnn::VkCompute& cmd,
+                    const uint64_t* frameIndex = nullptr);
+    bool createRung(Rung& rung);
+    bool warmRung(Rung& rung);
+
+    // Tiled path of runNCNNBatch: pre-pass, inference and composite of
+    // consecutive tiles overlap across the two blob sets
+    bool runTiledBatch(Rung& rung, const FrameData& frame1, const FrameData& frame2,
+                       const float* timesteps, uint32_t count, FrameData* outputs,
+                       VkSemaphore waitSemaphore);
+
+    void recordPrePass(VkCommandBuffer cmd, Rung& rung, uint32_t b,
+                       const FrameData* const frames[2], uint32_t originX, uint32_t originY);
+    void recordTilePost(VkCommandBuffer cmd, Rung& rung, uint32_t b, uint32_t slot,
+                        uint32_t tile, const FrameData& output);
+
+    // Precision selection: INT8 must beat FP16 by INT8_MIN_SPEEDUP on this
+    // device and keep INT8_MIN_PSNR against FP16 on the guard set
+    static constexpr float INT8_MIN_PSNR = 32.0f;      // dB
+    static constexpr float INT8_MIN_SPEEDUP = 1.1f;
+    static constexpr int BENCHMARK_RUNS = 5;
+
+    // Held-out replay pairs (rife-guard.rgb), RGB8 at guardWidth_ x guardHeight_
+    const uint8_t* guardFrames_ = nullptr;
+    std::vector<uint8_t> guardStorage_;     // Backs guardFrames_ when not in the bundle
+    uint32_t guardWidth_ = 0;
+    uint32_t guardHeight_ = 0;
+    uint32_t guardPairs_ = 0;
+
+    bool loadGuardSet(const std::string& modelDir);
+    void selectPrecision(const Rung& rung);
+    // Median per-pair time of BENCHMARK_RUNS passes over the guard pairs
+    // (negative on failure); the outputs are kept for the PSNR check
+    float benchmarkNet(ncnn::Net& net, const std::vector<ncnn::Mat>& inputs,
+                       std::vector<ncnn::Mat>& outputs);
+    static float psnr(const ncnn::Mat& a, const ncnn::Mat& b);
+    VkDescriptorSet getInputSet(Rung& rung, uint32_t b, int slot, VkImageView view);
+    VkDescriptorSet getOutputSet(Rung& rung, uint32_t b, uint32_t slot, VkImageView view);
+    // Input sets of blob set b for frames and output sets for count
+    // outputs (either may be null), resolved before recording so an
+    // exhausted pool fails the batch instead of a dispatch
+    bool cacheSets(Rung& rung, uint32_t b, const FrameData* const frames[2],
+                   const FrameData* outputs, uint32_t count);
+    void releaseInterop();
 #endif
 
-    // Fallback: GPU compute shader optical flow + warping
+    // Compute path: frame_warp and frame_blend over MotionEstimator flow
     bool initFallback();
-    bool runFallbackInterpolation(const FrameData& frame1, const FrameData& frame2,
-                                   float timestep, FrameData& output);
 
-    // Image scaling helpers
-    struct ScaledFrame {
+    /**
+     * Per timestep, frame1 warped forward and frame2 backward along the
+     * flow in flowSlot into warped_, then blended into the output (one
+     * submission, and completion semaphore, per output). The flow must
+     * already be estimated: queue order and a barrier cover the reads.
+     * Returns false only on failure; the budget is checked by the caller
+     * against lastInferenceMs_ (per frame).
+     */
+    bool runWarpBlend(const FrameData& frame1, const FrameData& frame2, uint32_t flowSlot,
+                      const float* timesteps, uint32_t count, FrameData* outputs);
+
+    // Both frames warped to the timestep, RGBA8 in GENERAL
+    struct WarpImage {
         VkImage image = VK_NULL_HANDLE;
         VkImageView view = VK_NULL_HANDLE;
         VkDeviceMemory memory = VK_NULL_HANDLE;
-        uint32_t width, height;
     };
+    WarpImage warped_[2];
+    bool createWarpImages(uint32_t width, uint32_t height);
+    void destroyWarpImages();
+
+    // frame_warp sets per (source frame, flow slot, destination): pooled
+    // outputs for extrapolation, warped_ for the compute path
+    MotionEstimator* motionEstimator_ = nullptr;
+    std::map<std::tuple<VkImageView, uint32_t, VkImageView>, VkDescriptorSet> warpSets_;
+    VkDescriptorSet getWarpSet(VkImageView source, uint32_t flowSlot, VkImageView output);
+    // frame_blend sets per output (the inputs are always warped_)
+    std::unordered_map<VkImageView, VkDescriptorSet> blendSets_;
+    VkDescriptorSet getBlendSet(VkImageView output);
+    void freeDescriptorCaches();
 
-    ScaledFrame downscale(const FrameData& frame);
-    void upscale(const ScaledFrame& src, FrameData& dst);
+    // Synthesis calls may come from several pipeline workers; the rung
+    // resources and descriptor caches serve one call at a time
+    std::mutex synthesisMutex_;
 
-    std::vector<ScaledFrame> scaledBuffers_;
     VkSampler linearSampler_ = VK_NULL_HANDLE;
 };
 
@@ -0,0 +1,58 @@
+/**
+ * Cadence Scheduler implementation — phase accumulator over frame pairs
+ */
+
+#include "cadence_scheduler.h"
+
+namespace framegen {
+
+CadenceScheduler::Plan CadenceScheduler::plan(uint64_t frame1Ns, uint64_t frame2Ns,
+                                              uint64_t outputIntervalNs) {
+    Plan result;
+
+    if (frame2Ns <= frame1Ns || outputIntervalNs == 0 ||
+        frame2Ns - frame1Ns > MAX_PAIR_INTERVAL_NS) {
+        // Hitch or bogus timestamps: show frame1 as is, restart at frame2
+        LOGD("CadenceScheduler: Re-anchoring after %.2f ms gap",
+             frame2Ns > frame1Ns ? ns_to_ms(frame2Ns - frame1Ns) : 0.0f);
+        result.presentSource = true;
+        nextSlotNs_ = frame2Ns;
+        anchored_ = true;
+        return result;
+    }
+
+    uint64_t interval = frame2Ns - frame1Ns;
+    uint64_t snap = static_cast<uint64_t>(static_cast<float>(outputIntervalNs) * SNAP_FRACTION);
+    sourceIntervalNs_.store(interval, std::memory_order_relaxed);
+
+    // First pair, or slots left behind (presenter stalled, pairs skipped)
+    if (!anchored_ || nextSlotNs_ + snap < frame1Ns) {
+        nextSlotNs_ = frame1Ns;
+        anchored_ = true;
+    }
+
+    // Slots within snap of frame2 belong to the next pair, as its source
+    while (nextSlotNs_ + snap < frame2Ns) {
+        if (nextSlotNs_ <= frame1Ns + snap) {
+            result.presentSource = true;
+        } else if (result.count < MAX_GENERATED) {
+            result.timesteps[result.count++] =
+                static_cast<float>(nextSlotNs_ - frame1Ns) / static_cast<float>(interval);
+        }
+        nextSlotNs_ += outputIntervalNs;
+    }
+    return result;
+}
+
+CadenceScheduler::Plan CadenceScheduler::planAhead(uint64_t frame1Ns, uint64_t frame2Ns,
+                                                   uint64_t outputIntervalNs) {
+    uint64_t interval = frame2Ns > frame1Ns ? frame2Ns - frame1Ns : 0;
+    anchored_ = false;
+
+    // A zero or hitch-sized span takes plan()'s re-anchor path: no frames
+    Plan result = plan(frame2Ns, frame2Ns + interval, outputIntervalNs);
+    result.presentSource = false;
+    return result;
+}
+
+} // namespace framegen
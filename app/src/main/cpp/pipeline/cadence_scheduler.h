@@ -0,0 +1,61 @@
+/**
+ * Cadence Scheduler — which display slots of a frame pair need a frame.
+ *
+ * A phase accumulator walks the output timeline (one slot per output
+ * interval) across the source timeline given by the captured frames'
+ * timestamp_ns. Every slot that falls inside a pair becomes either the
+ * pair's first frame (slot within SNAP_FRACTION of an interval of it) or
+ * a generated frame at the slot's exact fractional position. 40->120
+ * yields 2 frames per pair, 45->90 one, 40->90 alternates 2 and 1, and a
+ * game running faster than the output simply gets fewer slots.
+ *
+ * A hitch longer than MAX_PAIR_INTERVAL_NS, or a timeline that fell
+ * behind, re-anchors the accumulator on the next source frame.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <array>
+
+namespace framegen {
+
+class CadenceScheduler {
+public:
+    static constexpr uint32_t MAX_GENERATED = 7;            // Per pair
+    static constexpr float SNAP_FRACTION = 0.25f;           // Of the output interval
+    static constexpr uint64_t MAX_PAIR_INTERVAL_NS = 250'000'000;  // 250ms
+
+    struct Plan {
+        bool presentSource = false;   // frame1 itself occupies a slot
+        uint32_t count = 0;           // Frames to generate
+        std::array<float, MAX_GENERATED> timesteps{};  // Ascending, in (0,1)
+    };
+
+    /**
+     * Slots covered by the pair (frame1Ns, frame2Ns]; advances the phase.
+     * @param outputIntervalNs Time between output frames
+     */
+    Plan plan(uint64_t frame1Ns, uint64_t frame2Ns, uint64_t outputIntervalNs);
+
+    /**
+     * Extrapolation: slots after frame2 until the next frame is expected
+     * (frame2 + the pair's interval), timesteps relative to that span.
+     * frame2 itself is presented by the caller, so each call restarts the
+     * timeline on it; presentSource is never set.
+     */
+    Plan planAhead(uint64_t frame1Ns, uint64_t frame2Ns, uint64_t outputIntervalNs);
+
+    // Forget the phase; the next pair starts a fresh timeline
+    void reset() { anchored_ = false; }
+
+    // Last measured source interval (0 before the first pair)
+    uint64_t getSourceIntervalNs() const { return sourceIntervalNs_.load(std::memory_order_relaxed); }
+
+private:
+    uint64_t nextSlotNs_ = 0;     // Next output slot, on the source clock
+    bool anchored_ = false;
+    std::atomic<uint64_t> sourceIntervalNs_{0};
+};
+
+} // namespace framegen
@@ -0,0 +1,70 @@
+/**
+ * Cost Model implementation — recursive least squares over stage work terms
+ */
+
+#include "cost_model.h"
+#include <algorithm>
+
+namespace framegen {
+
+static constexpr double REFERENCE_RADIUS = 16.0;    // block_match.comp's MAX_SEARCH
+
+void CostModel::reset() {
+    weights_.fill(0.0);
+    for (size_t i = 0; i < TERMS; i++) {
+        covariance_[i].fill(0.0);
+        covariance_[i][i] = INITIAL_VARIANCE;
+    }
+    samples_ = 0;
+}
+
+CostModel::Terms CostModel::terms(const Inputs& inputs) const {
+    double mpx = static_cast<double>(inputs.width) * inputs.height / 1.0e6;
+    double frames = inputs.frames;
+
+    if (stage_ == Stage::ESTIMATE) {
+        // Pyramid build and matching cover the full frame; the diamond
+        // search's step size (not its candidate count) follows the radius
+        return {1.0, mpx, mpx * inputs.searchRadius / REFERENCE_RADIUS, 0.0};
+    }
+
+    // Flow once per pair, synthesis once per timestep, both in model space
+    double modelMpx = mpx * inputs.modelScale * inputs.modelScale;
+    return {1.0, frames, modelMpx, modelMpx * frames};
+}
+
+void CostModel::observe(const Inputs& inputs, float ms) {
+    Terms x = terms(inputs);
+
+    // P x and x' P x
+    Terms px{};
+    double xpx = 0.0;
+    for (size_t i = 0; i < TERMS; i++) {
+        for (size_t j = 0; j < TERMS; j++) px[i] += covariance_[i][j] * x[j];
+        xpx += x[i] * px[i];
+    }
+
+    double denom = 1.0 + xpx;
+    double error = ms;
+    for (size_t i = 0; i < TERMS; i++) error -= weights_[i] * x[i];
+
+    for (size_t i = 0; i < TERMS; i++) weights_[i] += px[i] / denom * error;
+    for (size_t i = 0; i < TERMS; i++) {
+        for (size_t j = 0; j < TERMS; j++) covariance_[i][j] -= px[i] * px[j] / denom;
+    }
+
+    // The true costs may have moved since; no further than the prior
+    for (size_t i = 0; i < TERMS; i++) {
+        covariance_[i][i] = std::min(covariance_[i][i] + DRIFT_VARIANCE, INITIAL_VARIANCE);
+    }
+    samples_++;
+}
+
+float CostModel::predict(const Inputs& inputs) const {
+    Terms x = terms(inputs);
+    double ms = 0.0;
+    for (size_t i = 0; i < TERMS; i++) ms += weights_[i] * x[i];
+    return static_cast<float>(std::max(ms, 0.0));
+}
+
+} // namespace framegen
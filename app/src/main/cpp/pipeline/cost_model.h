@@ -0,0 +1,68 @@
+/**
+ * Cost Model — online prediction of a pipeline stage's time per pair.
+ *
+ * A stage's time is modelled as a linear function of a few work terms
+ * derived from the settings it ran with (model scale, search radius,
+ * source resolution, frames generated), e.g. model-space pixels for RIFE
+ * inference or search area for block matching. The weights are fitted
+ * by recursive least squares with a random-walk drift term (a Kalman
+ * filter on the weights), so the model follows slow changes in clocks,
+ * thermals and scene content at a cost of a few dozen flops per sample.
+ * Unlike exponential forgetting, the drift is capped per weight, so
+ * holding one setting for minutes does not wind up the variance of the
+ * terms it does not exercise.
+ *
+ * Before a setting has been seen, the initial covariance spreads each
+ * measured time over the terms in proportion to their size: untried
+ * settings are predicted as if cost scaled with work.
+ *
+ * Not thread-safe; the owner serializes.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <array>
+
+namespace framegen {
+
+class CostModel {
+public:
+    enum class Stage : uint8_t {
+        ESTIMATE,       // Block-matching motion estimation
+        SYNTHESIZE,     // Frame generation for one pair
+    };
+
+    struct Inputs {
+        float modelScale = 0.5f;
+        uint32_t searchRadius = 16;     // Block-match radius (pixels)
+        uint32_t width = 0;             // Source resolution
+        uint32_t height = 0;
+        uint32_t frames = 1;            // Generated for the pair
+    };
+
+    static constexpr size_t TERMS = 4;
+    static constexpr double INITIAL_VARIANCE = 1000.0;  // Also the drift cap
+    static constexpr double DRIFT_VARIANCE = 2.0e-5;    // Per sample; ~50-sample memory
+
+    explicit CostModel(Stage stage = Stage::SYNTHESIZE) : stage_(stage) { reset(); }
+
+    void observe(const Inputs& inputs, float ms);
+    float predict(const Inputs& inputs) const;
+    void reset();
+
+    uint64_t samples() const { return samples_; }
+    const std::array<double, TERMS>& weights() const { return weights_; }
+
+private:
+    using Terms = std::array<double, TERMS>;
+
+    Stage stage_;
+    Terms weights_{};
+    std::array<Terms, TERMS> covariance_{};
+    uint64_t samples_ = 0;
+
+    Terms terms(const Inputs& inputs) const;
+};
+
+} // namespace framegen
@@ -0,0 +1,50 @@
+/**
+ * Frame Mailbox implementation — triple-buffer slot exchange
+ */
+
+#include "frame_mailbox.h"
+
+namespace framegen {
+
+std::optional<FrameMailbox::Pair> FrameMailbox::publish(const Pair& pair) {
+    slots_[back_] = pair;
+
+    // Release: the slot contents go with the index. Acquire: the slot we
+    // get back may be the one the consumer just gave up.
+    uint32_t old = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+    back_ = old & INDEX_MASK;
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    notifier_.notify();
+
+    if (old & FRESH) {
+        // The consumer never saw it
+        superseded_.fetch_add(1, std::memory_order_relaxed);
+        return slots_[back_];
+    }
+    return std::nullopt;
+}
+
+std::optional<FrameMailbox::Pair> FrameMailbox::take() {
+    // Only the consumer clears FRESH, so once seen it stays set until our
+    // exchange (the producer may swap in a newer pair first, still FRESH)
+    if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return std::nullopt;
+
+    uint32_t old = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = old & INDEX_MASK;
+    return slots_[front_];
+}
+
+std::optional<FrameMailbox::Pair> FrameMailbox::takeWait(uint64_t timeoutNs) {
+    if (auto pair = take()) return pair;
+
+    uint32_t key = notifier_.prepareWait();
+    if (auto pair = take()) {
+        notifier_.cancelWait();
+        return pair;
+    }
+    notifier_.wait(key, timeoutNs);
+    return take();
+}
+
+} // namespace framegen
@@ -0,0 +1,81 @@
+/**
+ * Frame Mailbox — latest-wins handoff of capture pairs.
+ *
+ * A lock-free triple buffer: the producer fills its back slot and swaps
+ * it into the middle, the consumer swaps the middle into its front slot.
+ * Neither side ever waits for the other, and the consumer always takes
+ * the newest pair. A pair still in the middle when the next one is
+ * published is superseded: it comes back out of publish() for the
+ * producer to release, and is counted.
+ *
+ * Used instead of the capture FrameQueue when the interpolation thread
+ * should work on the freshest frames rather than drain a backlog.
+ * Single producer, single consumer. Each pair holds one reference per
+ * valid handle, passed to whoever takes (or gets back) the pair.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include "frame_table.h"
+#include "wake_notifier.h"
+#include <array>
+#include <atomic>
+#include <optional>
+
+namespace framegen {
+
+class FrameMailbox {
+public:
+    struct Pair {
+        FrameHandle previous = INVALID_FRAME;   // Capture before current
+        FrameHandle current = INVALID_FRAME;
+    };
+
+    // Back, middle and front
+    static constexpr size_t SLOTS = 3;
+
+    FrameMailbox() = default;
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    /**
+     * Producer: make pair the newest.
+     * @return The superseded pair, if the consumer never took it
+     */
+    std::optional<Pair> publish(const Pair& pair);
+
+    // Consumer: the newest pair, if one arrived since the last take
+    std::optional<Pair> take();
+
+    // Consumer: take, parking for up to timeoutNs while there is none
+    std::optional<Pair> takeWait(uint64_t timeoutNs);
+
+    // Unpark the consumer without publishing (e.g. on shutdown)
+    void wakeConsumer() { notifier_.notify(); }
+    const WakeNotifier& notifier() const { return notifier_; }
+
+    // Pairs published / superseded before the consumer took them
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t superseded() const { return superseded_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t INDEX_MASK = 0x3;
+    static constexpr uint32_t FRESH = 0x4;      // Middle holds an untaken pair
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::array<Pair, SLOTS> slots_{};
+
+    // Middle slot index | FRESH — the only word both sides write
+    alignas(CACHE_LINE) std::atomic<uint32_t> middle_{1};
+
+    alignas(CACHE_LINE) uint32_t back_ = 0;     // Producer's
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> superseded_{0};
+
+    alignas(CACHE_LINE) uint32_t front_ = 2;    // Consumer's
+
+    alignas(CACHE_LINE) WakeNotifier notifier_;
+};
+
+} // namespace framegen
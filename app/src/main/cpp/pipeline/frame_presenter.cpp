@@ -3,8 +3,12 @@
  */
 
 #include "frame_presenter.h"
+#include "../interpolation/motion_estimator.h"
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cinttypes>
+#include <pthread.h>
 
 namespace framegen {
 
@@ -15,6 +19,7 @@ FramePresenter::~FramePresenter() {
 bool FramePresenter::init(const InitParams& params) {
     capture_ = params.capture;
     interpolator_ = params.interpolator;
+    timing_ = params.timing;
     device_ = params.device;
     presentQueue_ = params.presentQueue;
     swapchain_ = params.swapchain;
@@ -22,6 +27,44 @@ bool FramePresenter::init(const InitParams& params) {
     height_ = params.height;
     config_ = params.config;
 
+    // The capture ring skips images a queued or held frame still uses
+    if (capture_) capture_->setFrameTable(&frames_);
+
+    // Generated frames get pooled images for as many pairs as can hold
+    // them at once; nothing is allocated per frame after this
+    if (params.compute) {
+        uint32_t poolSize = OutputFramePool::sizeFor(config_.target_refresh_rate,
+                                                     MotionEstimator::FLOW_SLOTS);
+        if (!outputPool_.init(params.compute, &frames_, width_, height_, poolSize)) {
+            LOGE("FramePresenter: Failed to allocate output frame pool");
+            return false;
+        }
+    }
+
+    // Present on the big cluster, workers off the little one
+    threadPolicy_.discover();
+    threadPolicy_.setAffinityEnabled(config_.thread_affinity);
+    executor_.setThreadInit([this](const char* name) {
+        threadPolicy_.apply(ThreadPolicy::Role::WORKER, name);
+    });
+    compute_ = params.compute;
+    executor_.setThreadExit([this](const char*) {
+        if (compute_) compute_->releaseThreadCommandPool();
+    });
+
+    // The estimator's pyramid scratch images are shared by every pair, so
+    // a second estimate worker would only queue on its lock
+    if (config_.estimate_workers > 1) {
+        LOGW("FramePresenter: estimate_workers %u clamped to 1", config_.estimate_workers);
+        config_.estimate_workers = 1;
+    }
+
+    executor_.addStage("estimate", config_.estimate_workers,
+                       [this](PairJob& job) { estimateStage(job); });
+    executor_.addStage("synthesize", config_.synthesis_workers,
+                       [this](PairJob& job) { synthesizeStage(job); });
+    executor_.setRelease([this](PairJob& job) { releaseJob(job); });
+
     // Calculate present interval based on target refresh rate
     // 120Hz = 8.33ms, 90Hz = 11.1ms, 60Hz = 16.6ms
     presentIntervalNs_ = 1'000'000'000ULL / config_.target_refresh_rate;
@@ -33,8 +76,21 @@ bool FramePresenter::init(const InitParams& params) {
 
 void FramePresenter::shutdown() {
     stop();
-    capturedQueue_.clear();
-    presentQueue_q_.clear();
+
+    // Queued handles own references
+    while (auto handle = capturedQueue_.pop()) frames_.release(*handle);
+    while (auto pair = capturedMailbox_.take()) {
+        frames_.release(pair->previous);
+        frames_.release(pair->current);
+    }
+    frames_.release(lastCaptured_);
+    lastCaptured_ = INVALID_FRAME;
+    while (auto entry = presentQueue_q_.pop()) frames_.release(entry->frame);
+    frames_.release(previous_);
+    previous_ = INVALID_FRAME;
+
+    // Every frame is released, so no pooled image is in use
+    outputPool_.shutdown();
 }
 
 void FramePresenter::start() {
@@ -42,15 +98,20 @@ void FramePresenter::start() {
 
     running_ = true;
 
-    // Start interpolation thread (high priority)
+    // Per-pair flow fields are indexed by sequence % FLOW_SLOTS
+    executor_.start(MotionEstimator::FLOW_SLOTS);
+
+    // Start interpolation thread (worker placement)
     interpolationThread_ = std::thread([this] {
-        // Set thread priority for real-time performance
-        // On Android, use nice(-20) or sched_setscheduler
+        pthread_setname_np(pthread_self(), "fg-intake");
+        threadPolicy_.apply(ThreadPolicy::Role::WORKER, "fg-intake");
         interpolationLoop();
     });
 
-    // Start presentation thread (highest priority)
+    // Start presentation thread (big core; FIFO from the scheduler)
     presentationThread_ = std::thread([this] {
+        pthread_setname_np(pthread_self(), "fg-present");
+        threadPolicy_.apply(ThreadPolicy::Role::PRESENT, "fg-present");
         presentationLoop();
     });
 
@@ -61,94 +122,397 @@ void FramePresenter::stop() {
     if (!running_) return;
 
     running_ = false;
+    capturedQueue_.wakeConsumer();
+    capturedMailbox_.wakeConsumer();
 
     if (interpolationThread_.joinable()) {
         interpolationThread_.join();
     }
+    // Nothing submits any more; unfinished pairs drop their references
+    executor_.stop();
     if (presentationThread_.joinable()) {
         presentationThread_.join();
     }
 
-    LOGI("FramePresenter: Pipeline stopped. Generated: %" PRIu64 ", Dropped: %" PRIu64,
-         stats_.frames_generated.load(), stats_.frames_dropped.load());
+    LOGI("FramePresenter: Pipeline stopped. Generated: %" PRIu64 ", Dropped: %" PRIu64
+         ", Superseded: %" PRIu64,
+         stats_.frames_generated.load(), stats_.frames_dropped.load(),
+         capturedMailbox_.superseded());
 }
 
 void FramePresenter::onFrameCaptured(const FrameData& frame) {
-    if (!capturedQueue_.push(frame)) {
+    if (frame.image == VK_NULL_HANDLE) return;  // Capture skipped, ring busy
+
+    FrameHandle handle = frames_.acquire(frame);
+    if (handle == INVALID_FRAME) {
+        stats_.frames_dropped.fetch_add(1);
+        LOGW("FramePresenter: Frame table full, dropping frame %" PRIu64, frame.frame_index);
+        return;
+    }
+
+    if (config_.capture_mailbox) {
+        // The pair carries its own reference to the capture before it
+        FrameMailbox::Pair pair;
+        pair.previous = retainFrame(lastCaptured_);
+        pair.current = handle;
+        frames_.release(lastCaptured_);
+        lastCaptured_ = retainFrame(handle);
+
+        if (auto superseded = capturedMailbox_.publish(pair)) {
+            frames_.release(superseded->previous);
+            frames_.release(superseded->current);
+        }
+        return;
+    }
+
+    if (!capturedQueue_.push(handle)) {
+        frames_.release(handle);
         stats_.frames_dropped.fetch_add(1);
         LOGW("FramePresenter: Capture queue full, dropping frame %" PRIu64, frame.frame_index);
     }
 }
 
 // ============================================================
-// Interpolation thread — generates in-between frames
+// Interpolation thread — plans each pair and feeds the stages
 // ============================================================
 void FramePresenter::interpolationLoop() {
     LOGI("InterpolationThread: Started");
 
     while (running_) {
-        auto frameOpt = capturedQueue_.pop();
-        if (!frameOpt) {
-            // No frame available — yield briefly
-            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        // Our reference to it is kept while it is the previous frame
+        FrameHandle current = nextCaptured();
+        if (current == INVALID_FRAME) continue;
+        const FrameData& currentFrame = *frames_.get(current);
+
+        if (previous_ == INVALID_FRAME) {
+            // First frame — with interpolation on, the first pair's cadence
+            // plan presents it
+            if (config_.mode == Config::Mode::OFF || config_.extrapolation) {
+                PairJob job;
+                job.present = retainFrame(current);
+                job.sourceNs = currentFrame.timestamp_ns;
+                submitJob(job);
+            }
+            previous_ = current;
             continue;
         }
+        const FrameData& previousFrame = *frames_.get(previous_);
 
-        FrameData currentFrame = *frameOpt;
-        auto captureStart = now_ns();
-
-        if (!hasPreviousFrame_) {
-            // First frame — just pass through
-            presentQueue_q_.push(currentFrame);
-            previousFrame_ = currentFrame;
-            hasPreviousFrame_ = true;
-            continue;
+        if (config_.mode == Config::Mode::OFF) {
+            // Passthrough mode
+            PairJob job;
+            job.present = retainFrame(current);
+            job.sourceNs = currentFrame.timestamp_ns;
+            submitJob(job);
+            cadence_.reset();
+        } else if (config_.extrapolation) {
+            // Predictions past the previous frame are moot now that the
+            // real one is here
+            cancelGeneratedBefore(currentFrame.timestamp_ns);
+
+            // Newest frame goes out now, as its own job so it does not wait
+            // for the prediction; predicted frames fill the slots until the
+            // next one is expected
+            PairJob passthrough;
+            passthrough.present = retainFrame(current);
+            passthrough.sourceNs = currentFrame.timestamp_ns;
+            submitJob(passthrough);
+
+            PairJob job;
+            job.extrapolate = true;
+            job.sourceNs = currentFrame.timestamp_ns;
+            job.plan = cadence_.planAhead(
+                previousFrame.timestamp_ns, currentFrame.timestamp_ns, getOutputIntervalNs());
+            if (job.plan.count > 0) {
+                job.previous = retainFrame(previous_);
+                job.current = retainFrame(current);
+                submitJob(job);
+            }
+        } else {
+            // Pairs ending before the previous frame are more than a pair
+            // behind: whatever they still have queued would only add latency
+            cancelGeneratedBefore(previousFrame.timestamp_ns);
+
+            // Output slots of this pair, at the measured source interval
+            PairJob job;
+            job.sourceNs = currentFrame.timestamp_ns;
+            job.plan = cadence_.plan(
+                previousFrame.timestamp_ns, currentFrame.timestamp_ns, getOutputIntervalNs());
+            if (job.plan.presentSource) {
+                job.present = retainFrame(previous_);
+            }
+            if (job.plan.count > 0) {
+                job.previous = retainFrame(previous_);
+                job.current = retainFrame(current);
+            }
+            submitJob(job);
         }
 
-        // We have two frames — generate interpolated frames
-        uint32_t interpCount = getInterpolationCount();
+        frames_.release(previous_);
+        previous_ = current;
+    }
 
-        if (interpCount == 0 || config_.mode == Config::Mode::OFF) {
-            // Passthrough mode
-            presentQueue_q_.push(currentFrame);
-        } else {
-            // Push previous frame first
-            presentQueue_q_.push(previousFrame_);
-
-            // Generate intermediate frames
-            auto interpStart = now_ns();
-
-            std::vector<FrameData> interpolated;
-            bool success = interpolator_->interpolateMulti(
-                previousFrame_, currentFrame, interpCount, interpolated);
-
-            auto interpEnd = now_ns();
-            stats_.interpolation_ms.store(ns_to_ms(interpEnd - interpStart));
-
-            if (success) {
-                for (auto& frame : interpolated) {
-                    frame.width = width_;
-                    frame.height = height_;
-
-                    if (!presentQueue_q_.push(frame)) {
-                        stats_.frames_dropped.fetch_add(1);
-                        break;
-                    }
-                    stats_.frames_generated.fetch_add(1);
-                }
-            } else {
-                LOGW("InterpolationThread: Failed to interpolate, passing through");
-                stats_.frames_dropped.fetch_add(interpCount);
+    const WakeNotifier& notifier = config_.capture_mailbox ? capturedMailbox_.notifier()
+                                                           : capturedQueue_.notifier();
+    LOGI("InterpolationThread: Stopped (parked %" PRIu64 " times, %" PRIu64 " wake syscalls)",
+         notifier.parks(), notifier.wakeCalls());
+}
+
+FrameHandle FramePresenter::nextCaptured() {
+    // Parked until onFrameCaptured() publishes; the timeout only bounds
+    // how long a missed stop() could go unnoticed
+    if (!config_.capture_mailbox) {
+        auto handle = capturedQueue_.popWait(IDLE_WAIT_TIMEOUT_NS);
+        return handle ? *handle : INVALID_FRAME;
+    }
+
+    auto pair = capturedMailbox_.takeWait(IDLE_WAIT_TIMEOUT_NS);
+    if (!pair) return INVALID_FRAME;
+
+    if (pair->previous != INVALID_FRAME && pair->previous != previous_) {
+        // Captures in between were superseded; pair up the newest two
+        frames_.release(previous_);
+        previous_ = pair->previous;
+    } else {
+        frames_.release(pair->previous);
+    }
+    return pair->current;
+}
+
+void FramePresenter::submitJob(PairJob& job) {
+    // Blocks while the stages are full: backpressure reaches the capture
+    // queue, which drops instead of the pipeline growing
+    while (running_) {
+        if (executor_.submit(job, IDLE_WAIT_TIMEOUT_NS)) return;
+    }
+    job.cancelled = true;
+    releaseJob(job);
+}
+
+FrameHandle FramePresenter::retainFrame(FrameHandle handle) {
+    return frames_.retain(handle) ? handle : INVALID_FRAME;
+}
+
+// ============================================================
+// Stages — run on executor workers, several pairs at once
+// ============================================================
+void FramePresenter::estimateStage(PairJob& job) {
+    // RIFE infers its flow inside synthesis; extrapolation and the
+    // compute backend estimate it here, overlapping earlier pairs' synthesis
+    job.flowEstimated = job.extrapolate || interpolator_->estimatesFlow();
+    if (!job.flowEstimated || job.plan.count == 0) return;
+    if (job.sourceNs < cancelBeforeNs_.load(std::memory_order_acquire)) {
+        job.superseded = true;
+        return;
+    }
+
+    const FrameData* previous = frames_.get(job.previous);
+    const FrameData* current = frames_.get(job.current);
+    if (!previous || !current) {
+        job.failed = true;
+        return;
+    }
+
+    // Flow slots cycle with the sequence; the executor never has more
+    // than FLOW_SLOTS jobs in flight, so a slot is free when reused
+    job.searchRadius = interpolator_->getSearchRadius();
+    float ms = interpolator_->estimateFlow(*previous, *current,
+                                           job.sequence % MotionEstimator::FLOW_SLOTS);
+    if (ms < 0.0f) {
+        job.failed = true;
+        return;
+    }
+    stats_.motion_est_ms.store(ms);
+    job.estimateMs = ms;
+}
+
+void FramePresenter::synthesizeStage(PairJob& job) {
+    if (job.failed || job.superseded || job.plan.count == 0) return;
+    if (job.sourceNs < cancelBeforeNs_.load(std::memory_order_acquire)) {
+        job.superseded = true;
+        return;
+    }
+
+    const FrameData* previous = frames_.get(job.previous);
+    const FrameData* current = frames_.get(job.current);
+    if (!previous || !current) {
+        job.failed = true;
+        return;
+    }
+
+    // Reused per worker thread; backends keep the images we put in
+    static thread_local std::vector<FrameData> outputs;
+    outputs.assign(job.plan.count, FrameData{});
+
+    // One pooled image per output; if the pool runs dry the later
+    // timesteps are skipped (and counted dropped)
+    std::array<int32_t, CadenceScheduler::MAX_GENERATED> slots;
+    uint32_t count = job.plan.count;
+    if (outputPool_.size() > 0) {
+        for (uint32_t i = 0; i < job.plan.count; i++) {
+            slots[i] = outputPool_.claim(outputs[i]);
+            if (slots[i] == OutputFramePool::NO_SLOT) {
+                count = i;
+                break;
             }
         }
+        outputs.resize(count);
+    } else {
+        slots.fill(OutputFramePool::NO_SLOT);
+    }
+
+    bool success = true;
+    if (count > 0) {
+        job.modelScale = interpolator_->getModelScale();
+        auto interpStart = now_ns();
+        uint32_t flowSlot = job.sequence % MotionEstimator::FLOW_SLOTS;
+        if (job.extrapolate) {
+            success = interpolator_->extrapolate(*previous, *current, flowSlot,
+                                                 job.plan.timesteps.data(), count, outputs);
+        } else if (job.flowEstimated) {
+            success = interpolator_->interpolateFromFlow(*previous, *current, flowSlot,
+                                                         job.plan.timesteps.data(), count, outputs);
+        } else {
+            success = interpolator_->interpolateAt(*previous, *current,
+                                                   job.plan.timesteps.data(), count, outputs);
+        }
+        job.synthesizeMs = ns_to_ms(now_ns() - interpStart);
+        stats_.interpolation_ms.store(job.synthesizeMs);
+    }
+
+    if (success) {
+        for (auto& frame : outputs) {
+            if (job.generatedCount == job.generated.size()) break;
+            frame.width = width_;
+            frame.height = height_;
+            frame.is_interpolated = true;
+
+            FrameHandle handle = frames_.acquire(frame);
+            if (handle == INVALID_FRAME) break;
+            job.generated[job.generatedCount++] = handle;
+        }
+    } else {
+        job.failed = true;
+    }
+
+    // The table's references hold the used images from here; the rest
+    // are free again
+    for (uint32_t i = 0; i < count; i++) outputPool_.settle(slots[i]);
+}
+
+void FramePresenter::releaseJob(PairJob& job) {
+    // Serialized and in submission order, so the present queue keeps a
+    // single producer at a time and frames stay in timestamp order
+    std::array<PresentEntry, CadenceScheduler::MAX_GENERATED + 1> entries{};
+    size_t count = 0;
+    if (job.present != INVALID_FRAME) entries[count++] = makeEntry(job.present, job.sourceNs);
+    size_t firstGenerated = count;
+    for (uint32_t i = 0; i < job.generatedCount; i++) {
+        entries[count++] = makeEntry(job.generated[i], job.sourceNs);
+    }
+
+    // Cancelled while in flight: the generated frames go straight back
+    bool cancelled = job.superseded ||
+                     job.sourceNs < cancelBeforeNs_.load(std::memory_order_acquire);
+    size_t queued = cancelled ? firstGenerated : count;
+
+    // One publish and one wake for the whole pair; the queue now owns the
+    // pushed references
+    size_t pushed = job.cancelled ? 0 : presentQueue_q_.pushN(entries.data(), queued);
+    for (size_t i = pushed; i < count; i++) frames_.release(entries[i].frame);
+    frames_.release(job.previous);
+    frames_.release(job.current);
+
+    if (job.cancelled) return;
+
+    size_t presentPushed = std::min(pushed, firstGenerated);
+    stats_.frames_generated.fetch_add(pushed - presentPushed);
+    stats_.frames_dropped.fetch_add(count - pushed);
+
+    if (job.plan.count > 0) {
+        if (cancelled) {
+            cancelledFrames_.fetch_add(job.plan.count);
+        } else if (job.failed) {
+            LOGW("InterpolationThread: Failed to generate frames, passing through");
+        }
+        // Frames planned but never produced
+        stats_.frames_dropped.fetch_add(job.plan.count - job.generatedCount);
+        stats_.total_ms.store(ns_to_ms(now_ns() - job.submitNs));
+
+        if (!cancelled && !job.failed) reportTiming(job);
+    }
+}
+
+void FramePresenter::reportTiming(const PairJob& job) {
+    if (!timing_ || job.synthesizeMs < 0.0f || job.generatedCount == 0) return;
+
+    TimingController::PairSample sample;
+    sample.inputs.modelScale = job.modelScale;
+    sample.inputs.searchRadius = job.searchRadius;
+    sample.inputs.width = width_;
+    sample.inputs.height = height_;
+    sample.inputs.frames = job.generatedCount;
+    sample.estimateMs = job.estimateMs;
+    sample.synthesizeMs = job.synthesizeMs;
+
+    // Serialized with the other releases; a rung switch waits for the
+    // synthesis in progress, if any
+    if (auto settings = timing_->onPairComplete(sample)) {
+        interpolator_->setModelScale(settings->modelScale);
+        interpolator_->setSearchRadius(settings->searchRadius);
+    }
+}
 
-        auto totalEnd = now_ns();
-        stats_.total_ms.store(ns_to_ms(totalEnd - captureStart));
+void FramePresenter::cancelGeneratedBefore(uint64_t sourceNs) {
+    uint64_t current = cancelBeforeNs_.load(std::memory_order_relaxed);
+    while (current < sourceNs &&
+           !cancelBeforeNs_.compare_exchange_weak(current, sourceNs, std::memory_order_acq_rel)) {}
+}
+
+uint64_t FramePresenter::presentLatencyNs() const {
+    // A frame waits for its synthesis budget and a present slot; an
+    // interpolated pair also waits for its second frame to be captured
+    uint64_t latency = config_.max_frame_time_ns + presentIntervalNs_;
+    if (config_.mode != Config::Mode::OFF && !config_.extrapolation) {
+        latency += cadence_.getSourceIntervalNs();
+    }
+    return latency;
+}
 
-        previousFrame_ = currentFrame;
+PresentEntry FramePresenter::makeEntry(FrameHandle handle, uint64_t sourceNs) const {
+    PresentEntry entry;
+    entry.frame = handle;
+    entry.sourceNs = sourceNs;
+    if (const FrameData* frame = frames_.get(handle)) {
+        entry.targetNs = frame->timestamp_ns + presentLatencyNs();
     }
+    return entry;
+}
 
-    LOGI("InterpolationThread: Stopped");
+bool FramePresenter::isCancelled(FrameHandle handle, uint64_t sourceNs) const {
+    if (sourceNs >= cancelBeforeNs_.load(std::memory_order_acquire)) return false;
+    const FrameData* frame = frames_.get(handle);
+    return frame && frame->is_interpolated;
+}
+
+std::optional<PresentEntry> FramePresenter::popPresentable(uint64_t now) {
+    while (auto entry = presentQueue_q_.pop()) {
+        if (isCancelled(entry->frame, entry->sourceNs)) {
+            cancelledFrames_.fetch_add(1);
+        } else if (now > entry->targetNs + presentIntervalNs_ / 2) {
+            // Its slot has passed; showing it would push every later frame
+            // back. A late source frame with nothing behind it still beats
+            // repeating the previous one.
+            const FrameData* frame = frames_.get(entry->frame);
+            if (frame && !frame->is_interpolated && presentQueue_q_.empty()) return entry;
+            staleFrames_.fetch_add(1);
+        } else {
+            return entry;
+        }
+        frames_.release(entry->frame);
+        stats_.frames_dropped.fetch_add(1);
+    }
+    return std::nullopt;
 }
 
 // ============================================================
@@ -159,37 +523,27 @@ void FramePresenter::presentationLoop() {
 
     uint64_t frameCount = 0;
     auto fpsTimer = now_ns();
+    bool placementsLogged = false;
+
+    scheduler_.enableRealtime();
 
     while (running_) {
+        // Absolute sleep, then spin only the learned wakeup jitter
         uint64_t targetTime = lastPresentNs_ + presentIntervalNs_;
-        uint64_t currentTime = now_ns();
-
-        // Precise busy-wait for vsync timing
-        // Sleep for most of the remaining time, then spin
-        if (currentTime < targetTime) {
-            uint64_t remaining = targetTime - currentTime;
-            if (remaining > 2'000'000) { // > 2ms → sleep coarsely
-                std::this_thread::sleep_for(
-                    std::chrono::nanoseconds(remaining - 1'000'000));
-            }
-            // Spin for the last millisecond
-            while (now_ns() < targetTime) {
-                // Busy wait — essential for sub-ms precision
-            }
-        }
+        scheduler_.sleepUntil(targetTime);
 
-        auto frameOpt = presentQueue_q_.pop();
-        if (!frameOpt) {
+        auto entry = popPresentable(now_ns());
+        if (!entry) {
             // No frame ready — missed deadline
             stats_.frames_dropped.fetch_add(1);
             lastPresentNs_ = now_ns();
             continue;
         }
 
-        FrameData frame = *frameOpt;
-
+        // The frame (and its image) stays reserved until presented
         auto presentStart = now_ns();
-        presentFrame(frame);
+        presentFrame(*frames_.get(entry->frame));
+        frames_.release(entry->frame);
         auto presentEnd = now_ns();
 
         stats_.present_ms.store(ns_to_ms(presentEnd - presentStart));
@@ -205,9 +559,32 @@ void FramePresenter::presentationLoop() {
             frameCount = 0;
             fpsTimer = presentEnd;
 
-            LOGD("FPS: %.1f | Interp: %.2fms | Present: %.2fms | Queue: %zu",
+            for (const auto& stage : executor_.getStats()) {
+                LOGD("Stage %s: %.2fms x%u", stage.name, stage.avgMs, stage.workers);
+            }
+            // Every thread is up by the first report
+            if (!placementsLogged) {
+                threadPolicy_.logPlacements();
+                placementsLogged = true;
+            }
+            if (uint32_t misplaced = threadPolicy_.countMisplaced()) {
+                LOGW("PresentationThread: %u thread(s) running outside their cluster", misplaced);
+            }
+
+            if (uint64_t exhausted = outputPool_.exhausted()) {
+                LOGD("Output pool: %u images, exhausted %" PRIu64 " times",
+                     outputPool_.size(), exhausted);
+            }
+
+            auto jitter = scheduler_.getHistogram();
+            LOGD("FPS: %.1f | Interp: %.2fms | Present: %.2fms | Queue: %zu "
+                 "(stale %" PRIu64 ", cancelled %" PRIu64 ") | "
+                 "Wake p50/p99: %.3f/%.3fms (spin %.3fms)",
                  fps, stats_.interpolation_ms.load(),
-                 stats_.present_ms.load(), presentQueue_q_.size());
+                 stats_.present_ms.load(), presentQueue_q_.size(),
+                 staleFrames_.load(), cancelledFrames_.load(),
+                 ns_to_ms(jitter.percentileNs(0.5f)), ns_to_ms(jitter.percentileNs(0.99f)),
+                 ns_to_ms(scheduler_.getSpinThresholdNs()));
         }
     }
 
@@ -232,19 +609,20 @@ void FramePresenter::presentFrame(const FrameData& frame) {
     }
 }
 
-uint32_t FramePresenter::getInterpolationCount() const {
+uint64_t FramePresenter::getOutputIntervalNs() const {
+    uint32_t fps = 60;
     switch (config_.mode) {
-        case Config::Mode::OFF:
-            return 0;
-        case Config::Mode::FPS_60:
-            return 1;  // 30->60: generate 1 frame between each pair
         case Config::Mode::FPS_90:
-            return 2;  // 30->90: generate 2 frames between each pair
+            fps = 90;
+            break;
         case Config::Mode::FPS_120:
-            return 3;  // 30->120: generate 3 frames between each pair
+            fps = 120;
+            break;
         default:
-            return 1;
+            break;
     }
+    // Never faster than the display can show
+    return std::max<uint64_t>(1'000'000'000ULL / fps, presentIntervalNs_);
 }
 
 void FramePresenter::setQuality(float quality) {
@@ -252,6 +630,10 @@ void FramePresenter::setQuality(float quality) {
     if (interpolator_) {
         interpolator_->setQuality(quality);
     }
+    // The controller adapts from the rung just set, not its last choice
+    if (timing_) {
+        timing_->setQuality(quality);
+    }
 }
 
 } // namespace framegen
@@ -4,9 +4,14 @@
  * Orchestrates the entire pipeline:
  * 1. Takes captured frame pairs from the capture module
  * 2. Feeds them to the interpolation engine
- * 3. Inserts interpolated frames between originals
+ * 3. Inserts interpolated frames between originals (or, in extrapolation
+ *    mode, predicted frames after the newest one, which goes out at once)
  * 4. Presents the sequence at the target refresh rate
  *
+ * Steps 2-3 run as StageExecutor stages ("estimate", "synthesize"), so
+ * one pair's motion estimation overlaps the previous pair's synthesis;
+ * jobs reach the present queue in capture order.
+ *
  * Uses VK_GOOGLE_display_timing (or Choreographer) for precise vsync.
  */
 
@@ -14,7 +19,16 @@
 
 #include "../framegen_types.h"
 #include "frame_queue.h"
+#include "frame_mailbox.h"
+#include "frame_table.h"
+#include "present_scheduler.h"
+#include "cadence_scheduler.h"
+#include "stage_executor.h"
+#include "thread_policy.h"
+#include "output_frame_pool.h"
+#include "timing_controller.h"
 #include "../interpolation/rife_engine.h"
+#include "../interpolation/motion_estimator.h"
 #include "../vulkan/vulkan_capture.h"
 
 #include <thread>
@@ -31,6 +45,8 @@ public:
     struct InitParams {
         VulkanCapture* capture = nullptr;
         RifeEngine* interpolator = nullptr;
+        VulkanCompute* compute = nullptr;   // Allocates the output frame pool
+        TimingController* timing = nullptr; // Adapts quality to stage times
         VkDevice device = VK_NULL_HANDLE;
         VkQueue presentQueue = VK_NULL_HANDLE;
         VkSwapchainKHR swapchain = VK_NULL_HANDLE;
@@ -39,6 +55,24 @@ public:
         Config config;
     };
 
+    // Capture frames the captured queue holds; the mailbox's slots hold
+    // no more than this
+    static constexpr uint32_t CAPTURE_QUEUE_DEPTH = 8;
+    static_assert(FrameMailbox::SLOTS * 2 <= CAPTURE_QUEUE_DEPTH);
+
+    // Entries the present queue holds; with generation off every one is
+    // a captured frame
+    static constexpr uint32_t PRESENT_QUEUE_DEPTH = 16;
+
+    // Capture images in use at once: a full captured queue (or mailbox),
+    // a full present queue of source frames, the pair of each job in
+    // flight (one per flow slot), the producer's lastCaptured_ and the
+    // consumer's previous_, and the image being captured
+    static constexpr uint32_t CAPTURE_RING_SIZE =
+        CAPTURE_QUEUE_DEPTH + PRESENT_QUEUE_DEPTH + 2 * MotionEstimator::FLOW_SLOTS + 2 + 1;
+    static_assert(CAPTURE_RING_SIZE < FrameTable::CAPACITY / 2,
+                  "Half the frame table is left for generated frames");
+
     bool init(const InitParams& params);
     void shutdown();
 
@@ -53,8 +87,24 @@ public:
     PerfStats& getStats() { return stats_; }
     const PerfStats& getStats() const { return stats_; }
 
+    // Images generated frames are written into (0 without a compute pool)
+    uint32_t getOutputPoolSize() const { return outputPool_.size(); }
+
+    PresentScheduler::Histogram getPresentJitter() const { return scheduler_.getHistogram(); }
+    std::vector<ThreadPolicy::Placement> getThreadPlacements() {
+        return threadPolicy_.getPlacements();
+    }
+
+    /**
+     * Cancel generated frames derived from captures older than sourceNs:
+     * jobs still in the stages skip their work, queued frames are
+     * discarded instead of presented. Source frames are not affected.
+     */
+    void cancelGeneratedBefore(uint64_t sourceNs);
+
     // Runtime controls
     void setMode(Config::Mode mode) { config_.mode = mode; }
+    void setExtrapolation(bool enabled) { config_.extrapolation = enabled; }
     void setQuality(float quality);
 
     // Callback when a frame is ready for display
@@ -65,37 +115,84 @@ private:
     Config config_;
     VulkanCapture* capture_ = nullptr;
     RifeEngine* interpolator_ = nullptr;
+    TimingController* timing_ = nullptr;
     VkDevice device_ = VK_NULL_HANDLE;
     VkQueue presentQueue_ = VK_NULL_HANDLE;
     VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
     uint32_t width_ = 0, height_ = 0;
 
-    // Frame queues
-    FrameQueue<8> capturedQueue_;  // Raw captured frames
-    FrameQueue<16> presentQueue_q_; // Frames ready to present (including interpolated)
+    // In-flight frames; the queues carry handles into it
+    FrameTable frames_;
+
+    // Images generated frames are written into, recycled through frames_
+    OutputFramePool outputPool_;
+    VulkanCompute* compute_ = nullptr;  // Worker threads' command pools
+    FrameQueue<CAPTURE_QUEUE_DEPTH> capturedQueue_;  // Raw captured frames
+    FrameMailbox capturedMailbox_; // Or just the newest pair (capture_mailbox)
+    FrameHandle lastCaptured_ = INVALID_FRAME;  // Producer's, previous of the next pair
+    FrameQueue<PRESENT_QUEUE_DEPTH, PresentEntry> presentQueue_q_; // Frames ready to present (including interpolated)
 
     // Threading
     std::thread interpolationThread_;
     std::thread presentationThread_;
     std::atomic<bool> running_{false};
+    ThreadPolicy threadPolicy_;
 
     PerfStats stats_;
     PresentCallback presentCallback_;
 
-    // Previous frame for interpolation pairs
-    FrameData previousFrame_;
-    bool hasPreviousFrame_ = false;
+    // Previous frame for interpolation pairs (a held reference)
+    FrameHandle previous_ = INVALID_FRAME;
 
-    // Worker threads
+    // Next captured frame for the interpolation thread, INVALID_FRAME if
+    // none arrived in time. From the mailbox, a pair whose first frame is
+    // not previous_ means captures were superseded: it replaces previous_.
+    FrameHandle nextCaptured();
+
+    // Worker threads; the interpolation thread plans each pair and
+    // submits it to the executor
+    static constexpr uint64_t IDLE_WAIT_TIMEOUT_NS = 100'000'000;  // 100ms
     void interpolationLoop();
     void presentationLoop();
 
+    // Pair jobs: estimate -> synthesize -> releaseJob, in capture order
+    StageExecutor executor_;
+    void estimateStage(PairJob& job);
+    void synthesizeStage(PairJob& job);
+    void releaseJob(PairJob& job);
+
+    // Feed a finished pair's stage times to the timing controller and
+    // apply the settings it picks
+    void reportTiming(const PairJob& job);
+
+    // Submit a job whose references are held; dropped with them on stop
+    void submitJob(PairJob& job);
+
+    // A new reference to a held frame, INVALID_FRAME if it is stale
+    FrameHandle retainFrame(FrameHandle handle);
+
+    // Display deadlines: a frame is due at its content time plus the
+    // pipeline's latency, and is discarded once its slot has passed
+    uint64_t presentLatencyNs() const;
+    PresentEntry makeEntry(FrameHandle handle, uint64_t sourceNs) const;
+    std::atomic<uint64_t> cancelBeforeNs_{0};
+    std::atomic<uint64_t> staleFrames_{0};
+    std::atomic<uint64_t> cancelledFrames_{0};
+
+    // Pop the next frame worth presenting, discarding stale and cancelled
+    // ones; the newest source frame is kept even when late
+    std::optional<PresentEntry> popPresentable(uint64_t now);
+    bool isCancelled(FrameHandle handle, uint64_t sourceNs) const;
+
     // Timing
     uint64_t presentIntervalNs_ = 0; // Time between presented frames
     uint64_t lastPresentNs_ = 0;
+    PresentScheduler scheduler_;
 
-    // Determine how many interpolated frames to generate
-    uint32_t getInterpolationCount() const;
+    // Output frame rate of the mode, as the interval between output
+    // frames; the cadence turns it into per-pair generation plans
+    uint64_t getOutputIntervalNs() const;
+    CadenceScheduler cadence_;
 
     // Present a single frame with vsync timing
     void presentFrame(const FrameData& frame);
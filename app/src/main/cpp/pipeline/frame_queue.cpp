@@ -8,4 +8,5 @@
 namespace framegen {
     template class FrameQueue<8>;
     template class FrameQueue<16>;
+    template class FrameQueue<16, PresentEntry>;
 }
@@ -8,79 +8,197 @@
 #pragma once
 
 #include "../framegen_types.h"
+#include "frame_table.h"
+#include "wake_notifier.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <optional>
 
 namespace framegen {
 
+// A frame queued for display, with the time its display slot is due
+struct PresentEntry {
+    FrameHandle frame = INVALID_FRAME;
+    uint64_t targetNs = 0;      // now_ns() clock
+    uint64_t sourceNs = 0;      // Newest captured frame it derives from
+};
+
 /**
  * Single-producer, single-consumer lock-free frame queue.
  * Producer: capture/interpolation thread
  * Consumer: presenter thread
+ *
+ * Carries FrameHandles into a FrameTable (or entries holding one, like
+ * PresentEntry); a queued handle owns one reference, which passes to
+ * whoever pops it.
+ *
+ * head_ and tail_ run freely and are masked into the power-of-two
+ * buffer, so all Capacity slots are usable. Each side owns a cache line:
+ * its index plus a cached copy of the other side's. push() and pushN()
+ * re-read the tail only when the cached one says full; popN() re-reads
+ * the head when the cached one is short. pop() reads the live head, as
+ * a queue kept near empty would miss a cached one every time.
+ *
+ * popWait() parks an idle consumer on the queue's WakeNotifier; push()
+ * wakes it, with a syscall only when it is actually parked.
  */
-template<size_t Capacity = 8>
+template<size_t Capacity = 8, typename Entry = FrameHandle>
 class FrameQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "FrameQueue capacity must be a power of two");
+
 public:
     FrameQueue() = default;
 
-    bool push(const FrameData& frame) {
+    bool push(const Entry& frame) {
         size_t head = head_.load(std::memory_order_relaxed);
-        size_t next = (head + 1) % Capacity;
 
-        if (next == tail_.load(std::memory_order_acquire)) {
-            // Queue full — drop frame
-            droppedFrames_.fetch_add(1, std::memory_order_relaxed);
-            return false;
+        if (head - cachedTail_ == Capacity) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == Capacity) {
+                // Queue full — drop frame
+                droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
         }
 
-        buffer_[head] = frame;
-        head_.store(next, std::memory_order_release);
+        buffer_[head & MASK] = frame;
+        head_.store(head + 1, std::memory_order_release);
+        notifier_.notify();
         return true;
     }
 
-    std::optional<FrameData> pop() {
+    /**
+     * Push up to count frames in order, with one publish and one wake.
+     * Frames that do not fit are dropped (and counted); their
+     * references stay with the caller.
+     * @return Frames pushed
+     */
+    size_t pushN(const Entry* frames, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head - cachedTail_ + count > Capacity) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+        size_t n = std::min(count, Capacity - (head - cachedTail_));
+
+        if (n < count) {
+            // Queue full — drop the rest
+            droppedFrames_.fetch_add(count - n, std::memory_order_relaxed);
+            if (n == 0) return 0;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            buffer_[(head + i) & MASK] = frames[i];
+        }
+        head_.store(head + n, std::memory_order_release);
+        notifier_.notify();
+        return n;
+    }
+
+    std::optional<Entry> pop() {
         size_t tail = tail_.load(std::memory_order_relaxed);
 
         if (tail == head_.load(std::memory_order_acquire)) {
             return std::nullopt; // Empty
         }
 
-        FrameData frame = buffer_[tail];
-        tail_.store((tail + 1) % Capacity, std::memory_order_release);
+        Entry frame = buffer_[tail & MASK];
+        tail_.store(tail + 1, std::memory_order_release);
         return frame;
     }
 
-    std::optional<FrameData> peek() const {
+    /**
+     * Pop up to maxCount frames in order, with one release of the slots.
+     * @return Frames written to out
+     */
+    size_t popN(Entry* out, size_t maxCount) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        // pop() does not advance the cached head, so it may trail tail
+        // (wrapping the difference past Capacity)
+        size_t available = cachedHead_ - tail;
+        if (available < maxCount || available > Capacity) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            available = cachedHead_ - tail;
+        }
+        size_t n = std::min(maxCount, available);
+        if (n == 0) return 0;
+
+        for (size_t i = 0; i < n; i++) {
+            out[i] = buffer_[(tail + i) & MASK];
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * Pop, parking for up to timeoutNs while the queue is empty.
+     * May return empty early (wakeConsumer(), or a racing notify).
+     */
+    std::optional<Entry> popWait(uint64_t timeoutNs) {
+        if (auto frame = pop()) return frame;
+
+        uint32_t key = notifier_.prepareWait();
+        if (auto frame = pop()) {
+            notifier_.cancelWait();
+            return frame;
+        }
+        notifier_.wait(key, timeoutNs);
+        return pop();
+    }
+
+    // Unpark the consumer without pushing (e.g. on shutdown)
+    void wakeConsumer() { notifier_.notify(); }
+    const WakeNotifier& notifier() const { return notifier_; }
+
+    // Consumer side
+    std::optional<Entry> peek() const {
         size_t tail = tail_.load(std::memory_order_relaxed);
         if (tail == head_.load(std::memory_order_acquire)) {
             return std::nullopt;
         }
-        return buffer_[tail];
+        return buffer_[tail & MASK];
     }
 
+    // Any thread; a snapshot
     size_t size() const {
-        size_t head = head_.load(std::memory_order_acquire);
+        // tail first: head never falls behind a tail read before it
         size_t tail = tail_.load(std::memory_order_acquire);
-        return (head >= tail) ? (head - tail) : (Capacity - tail + head);
+        size_t head = head_.load(std::memory_order_acquire);
+        return std::min(head - tail, Capacity);
     }
 
     bool empty() const { return size() == 0; }
-    bool full() const { return size() == Capacity - 1; }
+    bool full() const { return size() == Capacity; }
 
     uint64_t droppedFrames() const { return droppedFrames_.load(std::memory_order_relaxed); }
     void resetStats() { droppedFrames_.store(0, std::memory_order_relaxed); }
 
+    // Only while neither side is running; queued references are not released
     void clear() {
         head_.store(0, std::memory_order_release);
         tail_.store(0, std::memory_order_release);
+        cachedTail_ = 0;
+        cachedHead_ = 0;
     }
 
 private:
-    std::array<FrameData, Capacity> buffer_;
-    std::atomic<size_t> head_{0};
-    std::atomic<size_t> tail_{0};
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Producer line
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
     std::atomic<uint64_t> droppedFrames_{0};
+
+    // Consumer line
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    alignas(CACHE_LINE) WakeNotifier notifier_;
+    alignas(CACHE_LINE) std::array<Entry, Capacity> buffer_;
 };
 
 } // namespace framegen
@@ -0,0 +1,112 @@
+/**
+ * Frame Table implementation — generation-checked, reference-counted slots
+ */
+
+#include "frame_table.h"
+
+namespace framegen {
+
+FrameHandle FrameTable::acquire(const FrameData& frame) {
+    uint32_t start = cursor_.load(std::memory_order_relaxed);
+
+    for (uint32_t n = 0; n < CAPACITY; n++) {
+        uint32_t index = (start + n) & (CAPACITY - 1);
+        Slot& slot = slots_[index];
+
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (stateRefs(state) != 0) continue;
+
+        uint32_t generation = (stateGeneration(state) + 1) & ((1u << GENERATION_BITS) - 1);
+        if (generation == 0) generation = 1;
+        if (!slot.state.compare_exchange_strong(state, (generation << REF_BITS) | 1,
+                                                std::memory_order_acq_rel)) {
+            continue;   // Taken by another acquire
+        }
+
+        // Nobody can resolve the new handle before we return it
+        slot.frame = frame;
+        slot.image.store(frame.image, std::memory_order_release);
+        cursor_.store(index + 1, std::memory_order_relaxed);
+        return (generation << INDEX_BITS) | index;
+    }
+
+    exhausted_.fetch_add(1, std::memory_order_relaxed);
+    return INVALID_FRAME;
+}
+
+bool FrameTable::retain(FrameHandle handle) {
+    if (handle == INVALID_FRAME) return false;
+    Slot& slot = slots_[handleIndex(handle)];
+
+    uint32_t state = slot.state.load(std::memory_order_relaxed);
+    do {
+        if (stateGeneration(state) != handleGeneration(handle) || stateRefs(state) == 0) {
+            return false;
+        }
+        if (stateRefs(state) == REF_MASK) {
+            LOGE("FrameTable: Reference count overflow on frame %08x", handle);
+            return false;
+        }
+    } while (!slot.state.compare_exchange_weak(state, state + 1, std::memory_order_relaxed));
+    return true;
+}
+
+void FrameTable::release(FrameHandle handle) {
+    if (handle == INVALID_FRAME) return;
+    Slot& slot = slots_[handleIndex(handle)];
+
+    // The image is left in place: a free slot is never reported by
+    // references(), and clearing it could race the slot's next acquire
+    uint32_t state = slot.state.load(std::memory_order_relaxed);
+    do {
+        if (stateGeneration(state) != handleGeneration(handle) || stateRefs(state) == 0) {
+            LOGW("FrameTable: Release of stale frame %08x", handle);
+            return;
+        }
+    } while (!slot.state.compare_exchange_weak(state, state - 1, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed));
+}
+
+const FrameTable::Slot* FrameTable::resolve(FrameHandle handle) const {
+    if (handle == INVALID_FRAME) return nullptr;
+    const Slot& slot = slots_[handleIndex(handle)];
+
+    uint32_t state = slot.state.load(std::memory_order_acquire);
+    if (stateGeneration(state) != handleGeneration(handle) || stateRefs(state) == 0) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+const FrameData* FrameTable::get(FrameHandle handle) const {
+    const Slot* slot = resolve(handle);
+    return slot ? &slot->frame : nullptr;
+}
+
+FrameData* FrameTable::get(FrameHandle handle) {
+    const Slot* slot = resolve(handle);
+    return slot ? &slots_[handleIndex(handle)].frame : nullptr;
+}
+
+bool FrameTable::references(VkImage image) const {
+    if (image == VK_NULL_HANDLE) return false;
+    for (const Slot& slot : slots_) {
+        // A slot between acquire and its image store still shows the old
+        // image: a transient false positive, never a miss
+        if (stateRefs(slot.state.load(std::memory_order_acquire)) != 0 &&
+            slot.image.load(std::memory_order_acquire) == image) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t FrameTable::liveCount() const {
+    uint32_t live = 0;
+    for (const Slot& slot : slots_) {
+        if (stateRefs(slot.state.load(std::memory_order_relaxed)) != 0) live++;
+    }
+    return live;
+}
+
+} // namespace framegen
@@ -0,0 +1,86 @@
+/**
+ * Frame Table — fixed slots for in-flight frames, addressed by handle.
+ *
+ * The pipeline queues pass 32-bit FrameHandles instead of ~100-byte
+ * FrameData copies. A handle is a slot index plus the slot's generation,
+ * so a handle kept past its frame's release resolves to nothing instead
+ * of to whatever frame reuses the slot.
+ *
+ * Every holder of a handle owns one reference: acquire() returns the
+ * first, retain() adds one per extra consumer, and release() drops one.
+ * A slot is recycled only when its count reaches zero, and while it is
+ * nonzero references() reports the frame's image as in use, so the
+ * capture ring never overwrites an image a consumer is still reading.
+ *
+ * Any thread may acquire, retain, release and resolve handles.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <array>
+
+namespace framegen {
+
+using FrameHandle = uint32_t;
+static constexpr FrameHandle INVALID_FRAME = 0;  // Generation 0 is never issued
+
+class FrameTable {
+public:
+    static constexpr uint32_t INDEX_BITS = 7;
+    static constexpr uint32_t CAPACITY = 1u << INDEX_BITS;  // Ring + both queues + slack
+
+    FrameTable() = default;
+    FrameTable(const FrameTable&) = delete;
+    FrameTable& operator=(const FrameTable&) = delete;
+
+    /**
+     * Copy a frame into a free slot, holding one reference for the caller.
+     * @return INVALID_FRAME when every slot is referenced
+     */
+    FrameHandle acquire(const FrameData& frame);
+
+    // Add a reference for another consumer; false if the handle is stale
+    bool retain(FrameHandle handle);
+
+    // Drop a reference; the slot is recycled when the last one goes
+    void release(FrameHandle handle);
+
+    // The frame behind a live handle, nullptr if stale. Valid while the
+    // caller holds its reference.
+    const FrameData* get(FrameHandle handle) const;
+    FrameData* get(FrameHandle handle);
+
+    // True while any live frame uses this image
+    bool references(VkImage image) const;
+
+    uint32_t liveCount() const;
+    uint64_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+private:
+    // Slot state word: generation (high bits) | reference count (low bits).
+    // Generations wrap at 2^GENERATION_BITS, skipping 0.
+    static constexpr uint32_t REF_BITS = 8;
+    static constexpr uint32_t REF_MASK = (1u << REF_BITS) - 1;
+    static constexpr uint32_t GENERATION_BITS = 32 - REF_BITS;
+    static_assert(GENERATION_BITS + INDEX_BITS <= 32, "Handle is generation | index");
+
+    struct Slot {
+        std::atomic<uint32_t> state{0};
+        std::atomic<VkImage> image{VK_NULL_HANDLE};  // Readable without the frame
+        FrameData frame;
+    };
+    std::array<Slot, CAPACITY> slots_;
+    std::atomic<uint32_t> cursor_{0};       // Where the next free-slot scan starts
+    std::atomic<uint64_t> exhausted_{0};    // acquire() calls that found no slot
+
+    static uint32_t stateGeneration(uint32_t state) { return state >> REF_BITS; }
+    static uint32_t stateRefs(uint32_t state) { return state & REF_MASK; }
+    static uint32_t handleIndex(FrameHandle handle) { return handle & (CAPACITY - 1); }
+    static uint32_t handleGeneration(FrameHandle handle) { return handle >> INDEX_BITS; }
+
+    // Slot of a live handle, nullptr if stale
+    const Slot* resolve(FrameHandle handle) const;
+};
+
+} // namespace framegen
@@ -0,0 +1,159 @@
+/**
+ * Output Frame Pool implementation — fixed images, recycled via the table
+ */
+
+#include "output_frame_pool.h"
+#include "../vulkan/vulkan_compute.h"
+#include <algorithm>
+
+namespace framegen {
+
+static constexpr VkFormat OUTPUT_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;  // rgba8 in the shaders
+
+OutputFramePool::~OutputFramePool() {
+    shutdown();
+}
+
+bool OutputFramePool::init(VulkanCompute* compute, const FrameTable* table,
+                           uint32_t width, uint32_t height, uint32_t count) {
+    compute_ = compute;
+    table_ = table;
+    width_ = width;
+    height_ = height;
+
+    for (uint32_t i = 0; i < count; i++) {
+        auto image = std::make_unique<Image>();
+        if (!createImage(*image)) {
+            LOGE("OutputFramePool: Failed to create output image %u of %u", i, count);
+            images_.push_back(std::move(image));
+            shutdown();
+            return false;
+        }
+        images_.push_back(std::move(image));
+    }
+
+    LOGI("OutputFramePool: %u images of %ux%u (%.1f MB)", count, width, height,
+         static_cast<float>(count) * width * height * 4 / (1024.0f * 1024.0f));
+    return true;
+}
+
+void OutputFramePool::shutdown() {
+    if (!compute_) return;
+
+    VkDevice dev = compute_->getDevice();
+    if (!images_.empty()) vkDeviceWaitIdle(dev);
+
+    for (auto& image : images_) {
+        if (image->view != VK_NULL_HANDLE) vkDestroyImageView(dev, image->view, nullptr);
+        if (image->image != VK_NULL_HANDLE) vkDestroyImage(dev, image->image, nullptr);
+        if (image->memory != VK_NULL_HANDLE) vkFreeMemory(dev, image->memory, nullptr);
+    }
+    images_.clear();
+    compute_ = nullptr;
+}
+
+int32_t OutputFramePool::claim(FrameData& frame) {
+    uint32_t count = size();
+    uint32_t start = cursor_.load(std::memory_order_relaxed);
+
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t slot = (start + n) % count;
+        Image& image = *images_[slot];
+
+        if (image.claimed.load(std::memory_order_relaxed)) continue;
+        if (table_->references(image.image)) continue;  // Queued or on screen
+
+        bool expected = false;
+        if (!image.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            continue;   // Taken by another synthesis worker
+        }
+
+        // A release between the check and the claim only frees it further;
+        // a frame acquired meanwhile would have needed this claim first
+        cursor_.store(slot + 1, std::memory_order_relaxed);
+        frame.image = image.image;
+        frame.image_view = image.view;
+        frame.memory = image.memory;
+        frame.width = width_;
+        frame.height = height_;
+        frame.format = OUTPUT_FORMAT;
+        return static_cast<int32_t>(slot);
+    }
+
+    exhausted_.fetch_add(1, std::memory_order_relaxed);
+    return NO_SLOT;
+}
+
+void OutputFramePool::settle(int32_t slot) {
+    if (slot < 0 || static_cast<uint32_t>(slot) >= size()) return;
+    images_[slot]->claimed.store(false, std::memory_order_release);
+}
+
+uint32_t OutputFramePool::sizeFor(uint32_t refreshRate, uint32_t pipelineDepth) {
+    // e.g. 120 Hz from 30 fps: 3 frames per pair
+    uint32_t perPair = (refreshRate + MIN_SOURCE_FPS - 1) / MIN_SOURCE_FPS - 1;
+    perPair = std::max<uint32_t>(perPair, 1);
+    return perPair * (pipelineDepth + PRESENT_DEPTH);
+}
+
+bool OutputFramePool::createImage(Image& image) {
+    VkDevice dev = compute_->getDevice();
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = OUTPUT_FORMAT;
+    imageInfo.extent = {width_, height_, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // Written by the synthesis shaders (storage) or a CPU backend's upload
+    // (transfer dst); read by presentation (sampled / transfer src)
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(dev, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkMemoryRequirements memReq;
+    vkGetImageMemoryRequirements(dev, image.image, &memReq);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReq.size;
+    // Find device local memory type
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(compute_->getPhysicalDevice(), &memProps);
+    allocInfo.memoryTypeIndex = 0;
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((memReq.memoryTypeBits & (1 << i)) &&
+            (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            allocInfo.memoryTypeIndex = i;
+            break;
+        }
+    }
+
+    if (vkAllocateMemory(dev, &allocInfo, nullptr, &image.memory) != VK_SUCCESS) {
+        return false;
+    }
+    vkBindImageMemory(dev, image.image, image.memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = OUTPUT_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    return vkCreateImageView(dev, &viewInfo, nullptr, &image.view) == VK_SUCCESS;
+}
+
+} // namespace framegen
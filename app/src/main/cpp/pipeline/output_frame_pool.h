@@ -0,0 +1,83 @@
+/**
+ * Output Frame Pool — pre-allocated images for generated frames.
+ *
+ * Every interpolated or extrapolated frame is written into one of a fixed
+ * set of images created at init, so synthesis allocates nothing per
+ * frame. An image is free when no live FrameTable frame references it
+ * and no synthesis has it claimed: claim() marks it, the frame goes into
+ * the table, and settle() drops the mark. From then on the table's
+ * reference count keeps it busy until the frame is presented (or
+ * discarded) and released — the same rule the capture ring uses.
+ *
+ * claim() and settle() may be called from several threads.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include "frame_table.h"
+#include <memory>
+#include <vector>
+
+namespace framegen {
+
+class VulkanCompute;
+
+class OutputFramePool {
+public:
+    static constexpr int32_t NO_SLOT = -1;
+
+    OutputFramePool() = default;
+    ~OutputFramePool();
+    OutputFramePool(const OutputFramePool&) = delete;
+    OutputFramePool& operator=(const OutputFramePool&) = delete;
+
+    /**
+     * Create count images of width x height (RGBA8; storage for the
+     * synthesis shaders, transfer for CPU backends and presentation).
+     */
+    bool init(VulkanCompute* compute, const FrameTable* table,
+              uint32_t width, uint32_t height, uint32_t count);
+    void shutdown();
+
+    /**
+     * Reserve a free image and describe it in frame (image, view,
+     * memory, size, format).
+     * @return The slot to settle(), NO_SLOT when every image is busy
+     */
+    int32_t claim(FrameData& frame);
+
+    // The claimed image is now referenced by the table (or was not used)
+    void settle(int32_t slot);
+
+    uint32_t size() const { return static_cast<uint32_t>(images_.size()); }
+    uint64_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+    /**
+     * Images for a display: the most frames one pair can need at the
+     * slowest source rate we plan for, times the pairs that can hold
+     * outputs at once (in the stages, then queued for present).
+     */
+    static uint32_t sizeFor(uint32_t refreshRate, uint32_t pipelineDepth);
+    static constexpr uint32_t MIN_SOURCE_FPS = 30;
+    static constexpr uint32_t PRESENT_DEPTH = 2;    // Pairs queued for present
+
+private:
+    struct Image {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        std::atomic<bool> claimed{false};
+    };
+
+    VulkanCompute* compute_ = nullptr;
+    const FrameTable* table_ = nullptr;
+    uint32_t width_ = 0, height_ = 0;
+    std::vector<std::unique_ptr<Image>> images_;
+    std::atomic<uint32_t> cursor_{0};       // Where the next scan starts
+    std::atomic<uint64_t> exhausted_{0};    // claim() calls that found none
+
+    bool createImage(Image& image);
+};
+
+} // namespace framegen
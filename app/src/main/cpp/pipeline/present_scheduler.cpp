@@ -0,0 +1,127 @@
+/**
+ * Present Scheduler implementation — absolute sleeps + adaptive spin
+ */
+
+#include "present_scheduler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace framegen {
+
+static_assert(std::is_same_v<Clock, std::chrono::steady_clock>,
+              "sleepUntil deadlines are CLOCK_MONOTONIC (steady_clock) times");
+
+static inline void cpuRelax() {
+#if defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+PresentScheduler::Policy PresentScheduler::enableRealtime() {
+    sched_param param{};
+    param.sched_priority = FIFO_PRIORITY;
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err == 0) {
+        policy_ = Policy::FIFO;
+        LOGI("PresentScheduler: SCHED_FIFO priority %d", FIFO_PRIORITY);
+        return policy_;
+    }
+
+    // Untrusted apps usually get EPERM; the display nice level is allowed
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), DISPLAY_NICE) == 0) {
+        policy_ = Policy::NICE;
+        LOGI("PresentScheduler: SCHED_FIFO unavailable (%d), using nice %d", err, DISPLAY_NICE);
+    } else {
+        policy_ = Policy::DEFAULT;
+        LOGW("PresentScheduler: Could not raise thread priority (%d/%d)", err, errno);
+    }
+    return policy_;
+}
+
+uint64_t PresentScheduler::sleepUntil(uint64_t deadlineNs) {
+    uint64_t now = now_ns();
+    if (now >= deadlineNs) {
+        missed_.fetch_add(1, std::memory_order_relaxed);
+        record(now - deadlineNs);
+        return 0;
+    }
+
+    uint64_t spin = spinThresholdNs_.load(std::memory_order_relaxed);
+    if (deadlineNs - now > spin) {
+        uint64_t wakeNs = deadlineNs - spin;
+        timespec wake{};
+        wake.tv_sec = static_cast<time_t>(wakeNs / 1'000'000'000ULL);
+        wake.tv_nsec = static_cast<long>(wakeNs % 1'000'000'000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {}
+
+        uint64_t woke = now_ns();
+        learnLateness(woke > wakeNs ? woke - wakeNs : 0);
+    }
+
+    // Only the learned margin is spent spinning
+    while ((now = now_ns()) < deadlineNs) {
+        cpuRelax();
+    }
+
+    uint64_t error = now - deadlineNs;
+    record(error);
+    return error;
+}
+
+void PresentScheduler::learnLateness(uint64_t latenessNs) {
+    float sample = static_cast<float>(latenessNs);
+    if (!haveSample_) {
+        latenessNs_ = sample;
+        deviationNs_ = sample / 2.0f;
+        haveSample_ = true;
+    } else {
+        deviationNs_ += DEVIATION_GAIN * (std::abs(sample - latenessNs_) - deviationNs_);
+        latenessNs_ += LATENESS_GAIN * (sample - latenessNs_);
+    }
+
+    float threshold = latenessNs_ + SPIN_DEVIATIONS * deviationNs_;
+    spinThresholdNs_.store(std::clamp(static_cast<uint64_t>(threshold), MIN_SPIN_NS, MAX_SPIN_NS),
+                           std::memory_order_relaxed);
+}
+
+void PresentScheduler::record(uint64_t errorNs) {
+    size_t bucket = std::min<size_t>(errorNs / BUCKET_NS, HISTOGRAM_BUCKETS - 1);
+    histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+PresentScheduler::Histogram PresentScheduler::getHistogram() const {
+    Histogram h;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        h.counts[i] = histogram_[i].load(std::memory_order_relaxed);
+        h.total += h.counts[i];
+    }
+    h.missed = missed_.load(std::memory_order_relaxed);
+    return h;
+}
+
+void PresentScheduler::resetHistogram() {
+    for (auto& count : histogram_) count.store(0, std::memory_order_relaxed);
+    missed_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t PresentScheduler::Histogram::percentileNs(float p) const {
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0f, 1.0f) * total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank && seen > 0) return (i + 1) * BUCKET_NS;
+    }
+    return HISTOGRAM_BUCKETS * BUCKET_NS;
+}
+
+} // namespace framegen
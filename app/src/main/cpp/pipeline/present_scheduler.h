@@ -0,0 +1,82 @@
+/**
+ * Present Scheduler — wakes the presentation thread at absolute deadlines.
+ *
+ * Sleeps with clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) until a
+ * learned margin before the deadline, then spins the rest. The margin
+ * tracks how late the kernel actually wakes us (mean + SPIN_DEVIATIONS x
+ * mean deviation, like a TCP RTO estimator), so on a quiet device the
+ * spin shrinks to tens of microseconds instead of a fixed millisecond.
+ *
+ * The presenting thread should call enableRealtime() once: SCHED_FIFO
+ * when the process may use it, otherwise the display nice level.
+ * Deadline error (wake - deadline) is recorded in a histogram that any
+ * thread can snapshot.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <array>
+
+namespace framegen {
+
+class PresentScheduler {
+public:
+    PresentScheduler() = default;
+
+    enum class Policy { DEFAULT, NICE, FIFO };
+
+    // Raise the calling thread's priority; returns what was granted
+    Policy enableRealtime();
+    Policy getPolicy() const { return policy_; }
+
+    /**
+     * Block until deadlineNs (now_ns() clock).
+     * @return Deadline error in ns (>= 0; 0 if the deadline had passed)
+     */
+    uint64_t sleepUntil(uint64_t deadlineNs);
+
+    uint64_t getSpinThresholdNs() const { return spinThresholdNs_.load(std::memory_order_relaxed); }
+
+    // Deadline error histogram: HISTOGRAM_BUCKETS of BUCKET_NS, the last
+    // one also counts everything beyond
+    static constexpr size_t HISTOGRAM_BUCKETS = 32;
+    static constexpr uint64_t BUCKET_NS = 25'000;   // 25us
+
+    struct Histogram {
+        std::array<uint64_t, HISTOGRAM_BUCKETS> counts{};
+        uint64_t total = 0;
+        uint64_t missed = 0;    // Deadline already past on entry
+
+        // Upper bound of the bucket holding percentile p (0-1), in ns
+        uint64_t percentileNs(float p) const;
+    };
+    Histogram getHistogram() const;
+    void resetHistogram();
+
+    static constexpr uint64_t MIN_SPIN_NS = 50'000;       // 50us
+    static constexpr uint64_t MAX_SPIN_NS = 2'000'000;    // 2ms
+    static constexpr uint64_t INITIAL_SPIN_NS = 1'000'000;
+    static constexpr float SPIN_DEVIATIONS = 4.0f;
+    static constexpr float LATENESS_GAIN = 0.125f;        // EWMA gains (RFC 6298)
+    static constexpr float DEVIATION_GAIN = 0.25f;
+    static constexpr int FIFO_PRIORITY = 2;               // Just above SCHED_OTHER work
+    static constexpr int DISPLAY_NICE = -8;               // THREAD_PRIORITY_URGENT_DISPLAY
+
+private:
+    Policy policy_ = Policy::DEFAULT;
+
+    // Wakeup lateness estimator, owned by the sleeping thread
+    float latenessNs_ = 0.0f;
+    float deviationNs_ = 0.0f;
+    bool haveSample_ = false;
+    std::atomic<uint64_t> spinThresholdNs_{INITIAL_SPIN_NS};
+
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> histogram_{};
+    std::atomic<uint64_t> missed_{0};
+
+    void learnLateness(uint64_t latenessNs);
+    void record(uint64_t errorNs);
+};
+
+} // namespace framegen
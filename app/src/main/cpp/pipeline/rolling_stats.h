@@ -0,0 +1,130 @@
+/**
+ * Rolling Stats — mean, min, max and percentiles over the last Window
+ * samples, each in O(1) per sample.
+ *
+ * - Mean: a ring of the samples plus a running sum.
+ * - Min / max: monotonic queues (ring buffers of (sequence, value)); a
+ *   sample enters and leaves each at most once, so push() is amortized
+ *   O(1) and the extremes are at the fronts.
+ * - Percentiles: a log-bucketed histogram of the window, SUB_BUCKETS per
+ *   octave from MIN_VALUE up (about 9% bucket width). A sample increments
+ *   its bucket on entry and decrements it on eviction; a lookup walks the
+ *   fixed BUCKETS array, independent of Window. Results are bucket upper
+ *   bounds clamped to [min, max].
+ *
+ * Not thread-safe; the owner serializes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace framegen {
+
+template<size_t Window>
+class RollingStats {
+    static_assert(Window >= 1 && Window <= UINT16_MAX, "Bucket counts are 16-bit");
+
+public:
+    static constexpr float MIN_VALUE = 0.05f;       // First bucket's upper bound (ms)
+    static constexpr uint32_t SUB_BUCKETS = 8;      // Per doubling
+    static constexpr uint32_t OCTAVES = 12;         // Up to MIN_VALUE * 2^12 (~205 ms)
+    static constexpr uint32_t BUCKETS = SUB_BUCKETS * OCTAVES + 1;  // Last: everything above
+
+    void push(float value) {
+        if (count_ == Window) evict();
+
+        uint64_t seq = pushed_++;
+        samples_[seq % Window] = value;
+        sum_ += value;
+        count_++;
+        histogram_[bucketOf(value)]++;
+
+        while (maxQueue_.size && maxQueue_.back().value <= value) maxQueue_.size--;
+        maxQueue_.push({seq, value});
+        while (minQueue_.size && minQueue_.back().value >= value) minQueue_.size--;
+        minQueue_.push({seq, value});
+    }
+
+    void reset() {
+        count_ = 0;
+        sum_ = 0.0;
+        histogram_.fill(0);
+        maxQueue_ = {};
+        minQueue_ = {};
+    }
+
+    size_t count() const { return count_; }
+    bool full() const { return count_ == Window; }
+    float last() const { return count_ ? samples_[(pushed_ - 1) % Window] : 0.0f; }
+    float mean() const { return count_ ? static_cast<float>(sum_ / count_) : 0.0f; }
+    float min() const { return count_ ? minQueue_.front().value : 0.0f; }
+    float max() const { return count_ ? maxQueue_.front().value : 0.0f; }
+
+    // Smallest bucket bound with at least p (0-1) of the window at or below
+    float percentile(float p) const {
+        if (count_ == 0) return 0.0f;
+        uint32_t rank = static_cast<uint32_t>(std::ceil(std::clamp(p, 0.0f, 1.0f) * count_));
+        rank = std::max<uint32_t>(rank, 1);
+
+        uint32_t seen = 0;
+        for (uint32_t b = 0; b < BUCKETS; b++) {
+            seen += histogram_[b];
+            if (seen >= rank) return std::clamp(upperBound(b), min(), max());
+        }
+        return max();
+    }
+
+    static uint32_t bucketOf(float value) {
+        if (!(value > MIN_VALUE)) return 0;
+        float octaves = std::log2(value / MIN_VALUE);
+        return std::min(static_cast<uint32_t>(std::ceil(octaves * SUB_BUCKETS)), BUCKETS - 1);
+    }
+
+    static float upperBound(uint32_t bucket) {
+        return MIN_VALUE * std::exp2(static_cast<float>(bucket) / SUB_BUCKETS);
+    }
+
+private:
+    struct Entry {
+        uint64_t seq;
+        float value;
+    };
+
+    // Deque over a fixed ring; never holds more than the window
+    struct MonotonicQueue {
+        std::array<Entry, Window> entries{};
+        size_t head = 0;
+        size_t size = 0;
+
+        const Entry& front() const { return entries[head]; }
+        const Entry& back() const { return entries[(head + size - 1) % Window]; }
+        void push(const Entry& e) { entries[(head + size++) % Window] = e; }
+        void popFront() { head = (head + 1) % Window; size--; }
+    };
+
+    std::array<float, Window> samples_{};
+    uint64_t pushed_ = 0;       // Sequence of the next sample
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    std::array<uint16_t, BUCKETS> histogram_{};
+    MonotonicQueue maxQueue_;
+    MonotonicQueue minQueue_;
+
+    void evict() {
+        uint64_t seq = pushed_ - Window;
+        float value = samples_[seq % Window];
+        sum_ -= value;
+        count_--;
+        histogram_[bucketOf(value)]--;
+
+        if (maxQueue_.size && maxQueue_.front().seq == seq) maxQueue_.popFront();
+        if (minQueue_.size && minQueue_.front().seq == seq) minQueue_.popFront();
+    }
+};
+
+} // namespace framegen
@@ -0,0 +1,184 @@
+/**
+ * Stage Executor implementation — bounded stage queues + in-order release
+ */
+
+#include "stage_executor.h"
+#include <algorithm>
+#include <cstdio>
+#include <pthread.h>
+
+namespace framegen {
+
+StageExecutor::~StageExecutor() {
+    stop();
+}
+
+bool StageExecutor::addStage(const char* name, uint32_t workers, StageFn fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || stages_.size() >= MAX_STAGES) {
+        LOGE("StageExecutor: Cannot add stage %s", name);
+        return false;
+    }
+
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->workers = std::clamp<uint32_t>(workers, 1, MAX_WORKERS);
+    stage->fn = std::move(fn);
+    stages_.push_back(std::move(stage));
+    return true;
+}
+
+bool StageExecutor::start(uint32_t maxInFlight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return false;
+
+    maxInFlight_ = std::max<uint32_t>(maxInFlight, 1);
+    running_ = true;
+
+    for (size_t i = 0; i < stages_.size(); i++) {
+        Stage& stage = *stages_[i];
+        for (uint32_t w = 0; w < stage.workers; w++) {
+            stage.threads.emplace_back([this, i] { workerLoop(i); });
+        }
+        LOGI("StageExecutor: Stage %s, %u worker(s)", stage.name, stage.workers);
+    }
+    return true;
+}
+
+void StageExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+        for (auto& stage : stages_) {
+            stage->notEmpty.notify_all();
+            stage->notFull.notify_all();
+        }
+        slotFree_.notify_all();
+    }
+
+    for (auto& stage : stages_) {
+        for (auto& thread : stage->threads) {
+            if (thread.joinable()) thread.join();
+        }
+        stage->threads.clear();
+    }
+
+    // Whatever is still queued leaves through release, in order, so the
+    // references it holds are dropped
+    std::vector<PairJob> leftovers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& stage : stages_) {
+            for (auto& job : stage->queue) leftovers.push_back(std::move(job));
+            stage->queue.clear();
+        }
+    }
+    for (auto& job : leftovers) {
+        job.cancelled = true;
+        finish(std::move(job));
+    }
+}
+
+bool StageExecutor::submit(PairJob& job, uint64_t timeoutNs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [&] {
+        return !running_ || (inFlight_ < maxInFlight_ &&
+                             (stages_.empty() || stages_[0]->queue.size() < QUEUE_DEPTH));
+    };
+    if (!slotFree_.wait_for(lock, std::chrono::nanoseconds(timeoutNs), ready) || !running_) {
+        return false;
+    }
+
+    job.sequence = nextSequence_++;
+    job.submitNs = now_ns();
+    inFlight_++;
+
+    if (stages_.empty()) {
+        lock.unlock();
+        finish(std::move(job));
+        return true;
+    }
+    stages_[0]->queue.push_back(std::move(job));
+    stages_[0]->notEmpty.notify_one();
+    return true;
+}
+
+void StageExecutor::workerLoop(size_t stageIndex) {
+    Stage& stage = *stages_[stageIndex];
+    char threadName[16];
+    snprintf(threadName, sizeof(threadName), "fg-%s", stage.name);
+    pthread_setname_np(pthread_self(), threadName);
+    if (threadInit_) threadInit_(threadName);
+
+    while (true) {
+        PairJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stage.notEmpty.wait(lock, [&] { return !running_ || !stage.queue.empty(); });
+            if (!running_) break;    // stop() flushes the queues
+
+            job = std::move(stage.queue.front());
+            stage.queue.pop_front();
+            stage.notFull.notify_one();
+            if (stageIndex == 0) slotFree_.notify_one();
+        }
+
+        uint64_t start = now_ns();
+        stage.fn(job);
+        stage.busyNs.fetch_add(now_ns() - start, std::memory_order_relaxed);
+        stage.jobs.fetch_add(1, std::memory_order_relaxed);
+
+        if (stageIndex + 1 == stages_.size()) {
+            finish(std::move(job));
+            continue;
+        }
+
+        Stage& next = *stages_[stageIndex + 1];
+        std::unique_lock<std::mutex> lock(mutex_);
+        next.notFull.wait(lock, [&] { return !running_ || next.queue.size() < QUEUE_DEPTH; });
+
+        // Handed on even when stopping, for stop() to flush
+        next.queue.push_back(std::move(job));
+        next.notEmpty.notify_one();
+    }
+
+    if (threadExit_) threadExit_(threadName);
+}
+
+void StageExecutor::finish(PairJob&& job) {
+    std::lock_guard<std::mutex> releaseLock(releaseMutex_);
+    finished_.emplace(job.sequence, std::move(job));
+
+    while (!finished_.empty() && finished_.begin()->first == nextRelease_) {
+        auto node = finished_.begin();
+        if (release_) release_(node->second);
+        finished_.erase(node);
+        nextRelease_++;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlight_--;
+        slotFree_.notify_one();
+    }
+}
+
+std::vector<StageExecutor::StageStats> StageExecutor::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<StageStats> stats;
+    for (const auto& stage : stages_) {
+        StageStats s;
+        s.name = stage->name;
+        s.workers = stage->workers;
+        s.jobs = stage->jobs.load(std::memory_order_relaxed);
+        s.avgMs = s.jobs ? ns_to_ms(stage->busyNs.load(std::memory_order_relaxed)) / s.jobs : 0.0f;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+uint32_t StageExecutor::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_;
+}
+
+} // namespace framegen
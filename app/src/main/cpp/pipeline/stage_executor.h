@@ -0,0 +1,152 @@
+/**
+ * Stage Executor — runs frame-pair jobs through a pipeline of stages.
+ *
+ * Each stage has its own worker threads and a bounded input queue, so
+ * while one stage works on pair n the previous stage can already take
+ * pair n+1: throughput is capped by the slowest stage, 1/max(stage),
+ * instead of 1/sum(stages) for one thread doing everything.
+ *
+ * Jobs get a sequence number on submit() and leave through the release
+ * callback strictly in that order (a reorder buffer holds early
+ * finishers), so frames reach the present queue in timestamp order even
+ * with several workers per stage. The release callback is serialized.
+ *
+ * At most maxInFlight jobs exist between submit() and release, which
+ * also bounds how far ahead a stage can run; per-pair resources indexed
+ * by sequence % maxInFlight are never shared by two live jobs.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include "frame_table.h"
+#include "cadence_scheduler.h"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace framegen {
+
+struct PairJob {
+    uint64_t sequence = 0;          // Assigned by submit()
+
+    // References held by the job until release
+    FrameHandle present = INVALID_FRAME;    // Source frame shown before the generated ones
+    FrameHandle previous = INVALID_FRAME;   // The pair, when frames are generated
+    FrameHandle current = INVALID_FRAME;
+
+    bool extrapolate = false;
+    bool flowEstimated = false;     // Set by the estimate stage when it fills the flow slot
+    CadenceScheduler::Plan plan;
+    uint64_t sourceNs = 0;          // Capture time of the newest frame it uses
+
+    // Set by a stage that finds the job cancelled by a newer frame;
+    // later stages skip it
+    bool superseded = false;
+
+    // Filled by the stages
+    bool failed = false;
+    uint32_t generatedCount = 0;
+    std::array<FrameHandle, CadenceScheduler::MAX_GENERATED> generated{};
+
+    // Stage times (ms, negative when the stage had no work) and the
+    // settings they ran with, for the timing controller
+    float estimateMs = -1.0f;
+    float synthesizeMs = -1.0f;
+    uint32_t searchRadius = 0;
+    float modelScale = 0.0f;
+
+    bool cancelled = false;         // Set on jobs flushed by stop()
+    uint64_t submitNs = 0;
+};
+
+class StageExecutor {
+public:
+    using StageFn = std::function<void(PairJob& job)>;
+    using ReleaseFn = std::function<void(PairJob& job)>;
+    using ThreadInitFn = std::function<void(const char* threadName)>;
+
+    static constexpr size_t MAX_STAGES = 4;
+    static constexpr uint32_t MAX_WORKERS = 4;     // Per stage
+    static constexpr size_t QUEUE_DEPTH = 2;       // Jobs waiting per stage
+
+    StageExecutor() = default;
+    ~StageExecutor();
+    StageExecutor(const StageExecutor&) = delete;
+    StageExecutor& operator=(const StageExecutor&) = delete;
+
+    // Before start(); stages run in the order added
+    bool addStage(const char* name, uint32_t workers, StageFn fn);
+    void setRelease(ReleaseFn fn) { release_ = std::move(fn); }
+
+    // Run first on every worker thread (placement, priority)
+    void setThreadInit(ThreadInitFn fn) { threadInit_ = std::move(fn); }
+
+    // Run last on every worker thread, after its final job (per-thread
+    // resources such as command pools)
+    void setThreadExit(ThreadInitFn fn) { threadExit_ = std::move(fn); }
+
+    bool start(uint32_t maxInFlight);
+
+    // Joins the workers; unfinished jobs are released with cancelled set
+    void stop();
+
+    /**
+     * Queue a job, blocking while maxInFlight jobs are outstanding.
+     * @return false on timeout or when stopped (the job is untouched)
+     */
+    bool submit(PairJob& job, uint64_t timeoutNs);
+
+    struct StageStats {
+        const char* name = "";
+        uint32_t workers = 0;
+        uint64_t jobs = 0;
+        float avgMs = 0.0f;         // Mean time in the stage function
+    };
+    std::vector<StageStats> getStats() const;
+    uint32_t getInFlight() const;
+
+private:
+    struct Stage {
+        const char* name = "";
+        uint32_t workers = 1;
+        StageFn fn;
+        std::deque<PairJob> queue;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::vector<std::thread> threads;
+        std::atomic<uint64_t> jobs{0};
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+    ReleaseFn release_;
+    ThreadInitFn threadInit_;
+    ThreadInitFn threadExit_;
+
+    // One lock for all stage queues and the in-flight count: a handful of
+    // jobs per display frame, so contention is negligible
+    mutable std::mutex mutex_;
+    std::condition_variable slotFree_;
+    bool running_ = false;
+    uint32_t maxInFlight_ = 1;
+    uint32_t inFlight_ = 0;
+    uint64_t nextSequence_ = 0;
+
+    // Finished jobs waiting for their predecessors
+    std::mutex releaseMutex_;
+    std::map<uint64_t, PairJob> finished_;
+    uint64_t nextRelease_ = 0;
+
+    void workerLoop(size_t stageIndex);
+    void finish(PairJob&& job);
+};
+
+} // namespace framegen
@@ -0,0 +1,228 @@
+/**
+ * Thread Policy implementation — sysfs topology, affinity, uclamp, nice
+ */
+
+#include "thread_policy.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace framegen {
+
+// sched_setattr(2) has no libc wrapper on Android
+struct SchedAttr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+    uint32_t sched_util_min;
+    uint32_t sched_util_max;
+};
+
+static constexpr uint64_t SCHED_FLAG_KEEP_POLICY = 0x08;
+static constexpr uint64_t SCHED_FLAG_KEEP_PARAMS = 0x10;
+static constexpr uint64_t SCHED_FLAG_UTIL_CLAMP_MIN = 0x20;
+static constexpr uint64_t SCHED_FLAG_UTIL_CLAMP_MAX = 0x40;
+static constexpr uint32_t UCLAMP_SCALE = 1024;
+static constexpr int MAX_CPUS = 64;         // One uint64_t mask
+
+size_t ThreadPolicy::discover() {
+    clusters_.clear();
+
+    DIR* dir = opendir(sysfsRoot_.c_str());
+    if (!dir) {
+        LOGW("ThreadPolicy: No CPU topology at %s", sysfsRoot_.c_str());
+        return 0;
+    }
+
+    // max frequency -> CPUs; offline cores have no cpufreq and are skipped
+    std::map<uint32_t, uint64_t> byFreq;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        int cpu = -1;
+        char tail = 0;
+        if (sscanf(entry->d_name, "cpu%d%c", &cpu, &tail) != 1) continue;
+        if (cpu < 0 || cpu >= MAX_CPUS) continue;
+
+        std::ifstream file(sysfsRoot_ + "/" + entry->d_name + "/cpufreq/cpuinfo_max_freq");
+        uint32_t khz = 0;
+        if (!(file >> khz) || khz == 0) continue;
+        byFreq[khz] |= 1ULL << cpu;
+    }
+    closedir(dir);
+
+    for (const auto& [khz, mask] : byFreq) {
+        clusters_.push_back({khz, mask});
+        LOGI("ThreadPolicy: Cluster %zu: %u MHz, cpus 0x%llx", clusters_.size() - 1,
+             khz / 1000, static_cast<unsigned long long>(mask));
+    }
+    return clusters_.size();
+}
+
+uint64_t ThreadPolicy::cpusFor(Role role) const {
+    // Symmetric (or unknown) topology: nothing to choose between
+    if (clusters_.size() < 2) return 0;
+
+    switch (role) {
+        case Role::PRESENT:
+            return clusters_.back().cpuMask;
+        case Role::WORKER: {
+            uint64_t mask = 0;
+            for (size_t i = 1; i < clusters_.size(); i++) mask |= clusters_[i].cpuMask;
+            return mask;
+        }
+        case Role::TELEMETRY:
+            return clusters_.front().cpuMask;
+    }
+    return 0;
+}
+
+ThreadPolicy::Placement ThreadPolicy::apply(Role role, const char* name) {
+    Placement placement;
+    placement.tid = static_cast<pid_t>(syscall(SYS_gettid));
+    placement.name = name;
+    placement.role = role;
+    placement.requestedMask = affinityEnabled_ ? cpusFor(role) : 0;
+
+    if (placement.requestedMask != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+            if (placement.requestedMask & (1ULL << cpu)) CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            LOGW("ThreadPolicy: %s: affinity 0x%llx refused (%d)", name,
+                 static_cast<unsigned long long>(placement.requestedMask), errno);
+        }
+    }
+
+    placement.uclamp = setUclamp(role);
+
+    // The present thread's priority is PresentScheduler's (FIFO or nice)
+    int nice = role == Role::WORKER ? WORKER_NICE
+             : role == Role::TELEMETRY ? TELEMETRY_NICE : 0;
+    if (nice != 0 && setpriority(PRIO_PROCESS, static_cast<id_t>(placement.tid), nice) != 0) {
+        LOGW("ThreadPolicy: %s: nice %d refused (%d)", name, nice, errno);
+    }
+
+    refresh(placement);
+    LOGI("ThreadPolicy: %s (%s) on 0x%llx, nice %d, uclamp %s", name, roleName(role),
+         static_cast<unsigned long long>(placement.effectiveMask), placement.nice,
+         placement.uclamp ? "on" : "off");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    placements_.push_back(placement);
+    return placement;
+}
+
+bool ThreadPolicy::setUclamp(Role role) {
+    SchedAttr attr{};
+    attr.size = sizeof(attr);
+    attr.sched_flags = SCHED_FLAG_KEEP_POLICY | SCHED_FLAG_KEEP_PARAMS;
+    attr.sched_util_max = UCLAMP_SCALE;
+
+    switch (role) {
+        case Role::PRESENT:
+            attr.sched_flags |= SCHED_FLAG_UTIL_CLAMP_MIN;
+            attr.sched_util_min = PRESENT_UCLAMP_MIN;
+            break;
+        case Role::WORKER:
+            attr.sched_flags |= SCHED_FLAG_UTIL_CLAMP_MIN;
+            attr.sched_util_min = WORKER_UCLAMP_MIN;
+            break;
+        case Role::TELEMETRY:
+            attr.sched_flags |= SCHED_FLAG_UTIL_CLAMP_MAX;
+            attr.sched_util_max = TELEMETRY_UCLAMP_MAX;
+            break;
+    }
+
+    // Kernels without CONFIG_UCLAMP_TASK reject the flags (EINVAL/E2BIG)
+    return syscall(SYS_sched_setattr, 0, &attr, 0) == 0;
+}
+
+bool ThreadPolicy::refresh(Placement& placement) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", placement.tid);
+    std::ifstream file(path);
+    std::string stat;
+    if (!std::getline(file, stat)) return false;
+
+    // Field 39 (processor) counts from after the parenthesized name
+    size_t pos = stat.rfind(')');
+    if (pos != std::string::npos) {
+        const char* p = stat.c_str() + pos + 1;
+        for (int field = 3; field < 39 && *p; field++) {
+            p = strchr(p + 1, ' ');
+            if (!p) break;
+        }
+        if (p) placement.lastCpu = atoi(p + 1);
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(placement.tid, sizeof(set), &set) == 0) {
+        placement.effectiveMask = 0;
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+            if (CPU_ISSET(cpu, &set)) placement.effectiveMask |= 1ULL << cpu;
+        }
+    }
+    placement.policy = sched_getscheduler(placement.tid);
+    errno = 0;
+    int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(placement.tid));
+    if (errno == 0) placement.nice = nice;
+    return true;
+}
+
+std::vector<ThreadPolicy::Placement> ThreadPolicy::getPlacements() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    placements_.erase(std::remove_if(placements_.begin(), placements_.end(),
+                                     [](Placement& p) { return !refresh(p); }),
+                      placements_.end());
+    return placements_;
+}
+
+uint32_t ThreadPolicy::countMisplaced() {
+    uint32_t misplaced = 0;
+    for (const Placement& p : getPlacements()) {
+        if (p.requestedMask != 0 && p.lastCpu >= 0 && p.lastCpu < MAX_CPUS &&
+            !(p.requestedMask & (1ULL << p.lastCpu))) {
+            misplaced++;
+        }
+    }
+    return misplaced;
+}
+
+void ThreadPolicy::logPlacements() {
+    for (const Placement& p : getPlacements()) {
+        LOGI("ThreadPolicy: %-14s %-9s tid %d cpu %d, mask 0x%llx (asked 0x%llx), "
+             "policy %d, nice %d, uclamp %s",
+             p.name.c_str(), roleName(p.role), p.tid, p.lastCpu,
+             static_cast<unsigned long long>(p.effectiveMask),
+             static_cast<unsigned long long>(p.requestedMask), p.policy, p.nice,
+             p.uclamp ? "on" : "off");
+    }
+}
+
+const char* ThreadPolicy::roleName(Role role) {
+    switch (role) {
+        case Role::PRESENT:   return "present";
+        case Role::WORKER:    return "worker";
+        case Role::TELEMETRY: return "telemetry";
+    }
+    return "?";
+}
+
+} // namespace framegen
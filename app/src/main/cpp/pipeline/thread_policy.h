@@ -0,0 +1,114 @@
+/**
+ * Thread Policy — places engine threads on big.LITTLE clusters by role.
+ *
+ * The topology comes from sysfs: CPUs with the same cpuinfo_max_freq form
+ * a cluster, ordered little -> big. Roles map onto clusters:
+ *
+ *   PRESENT   — the biggest cluster (a missed wakeup is a missed frame)
+ *   WORKER    — every cluster but the little one (big + mid)
+ *   TELEMETRY — the little cluster
+ *
+ * apply() pins the calling thread, then sets what the process may: a
+ * utilization clamp (uclamp, so the governor keeps the core's frequency
+ * up) and a nice level. SCHED_FIFO for the present thread stays with
+ * PresentScheduler::enableRealtime(). Anything refused is logged and
+ * skipped; a thread is never left worse off than before.
+ *
+ * getPlacements() reports where registered threads actually are — the
+ * granted affinity, policy, nice and the CPU each last ran on — since a
+ * thread migrated to a little core is the usual cause of missed present
+ * deadlines.
+ *
+ * The sysfs root is a constructor argument, so discovery runs against a
+ * fake tree (cpuN/cpufreq/cpuinfo_max_freq files) off-device.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace framegen {
+
+class ThreadPolicy {
+public:
+    static constexpr const char* DEFAULT_SYSFS_ROOT = "/sys/devices/system/cpu";
+
+    explicit ThreadPolicy(std::string sysfsRoot = DEFAULT_SYSFS_ROOT)
+        : sysfsRoot_(std::move(sysfsRoot)) {}
+
+    enum class Role : uint8_t { PRESENT, WORKER, TELEMETRY };
+
+    struct Cluster {
+        uint32_t maxFreqKhz = 0;
+        uint64_t cpuMask = 0;       // Bit n = cpu n
+    };
+
+    /**
+     * Read the CPU topology. Without cpufreq (or with one cluster) every
+     * role gets all CPUs and apply() leaves affinity alone.
+     * @return Number of clusters found
+     */
+    size_t discover();
+    const std::vector<Cluster>& getClusters() const { return clusters_; }
+
+    // CPUs a role runs on, 0 = unrestricted
+    uint64_t cpusFor(Role role) const;
+
+    // Disable pinning (priorities are still raised)
+    void setAffinityEnabled(bool enabled) { affinityEnabled_ = enabled; }
+
+    struct Placement {
+        pid_t tid = 0;
+        std::string name;
+        Role role = Role::WORKER;
+        uint64_t requestedMask = 0;
+        uint64_t effectiveMask = 0;     // sched_getaffinity
+        int policy = 0;                 // SCHED_OTHER / SCHED_FIFO / ...
+        int nice = 0;
+        bool uclamp = false;            // Utilization clamp accepted
+        int lastCpu = -1;               // /proc/self/task/<tid>/stat
+    };
+
+    /**
+     * Place the calling thread for its role and register it.
+     * @return What was granted
+     */
+    Placement apply(Role role, const char* name);
+
+    // Fresh snapshot of every registered thread still alive
+    std::vector<Placement> getPlacements();
+
+    // Registered threads last seen outside their role's CPUs
+    uint32_t countMisplaced();
+
+    void logPlacements();
+
+    static const char* roleName(Role role);
+
+    // Utilization clamps (0-1024), and nice levels for the roles
+    // PresentScheduler does not prioritize
+    static constexpr uint32_t PRESENT_UCLAMP_MIN = 512;
+    static constexpr uint32_t WORKER_UCLAMP_MIN = 256;
+    static constexpr uint32_t TELEMETRY_UCLAMP_MAX = 256;
+    static constexpr int WORKER_NICE = -4;          // THREAD_PRIORITY_DISPLAY
+    static constexpr int TELEMETRY_NICE = 10;       // THREAD_PRIORITY_BACKGROUND
+
+private:
+    std::string sysfsRoot_;
+    std::vector<Cluster> clusters_;     // Ascending max frequency
+    bool affinityEnabled_ = true;
+
+    std::mutex mutex_;
+    std::vector<Placement> placements_;
+
+    bool setUclamp(Role role);
+
+    // Affinity, policy, nice and last CPU of tid; false if it has exited
+    static bool refresh(Placement& placement);
+};
+
+} // namespace framegen
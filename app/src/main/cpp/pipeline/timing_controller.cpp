@@ -5,8 +5,10 @@
 #include "timing_controller.h"
 #include <fstream>
 #include <algorithm>
-#include <numeric>
+#include <array>
+#include <cmath>
 #include <cstdio>
+#include <iterator>
 #include <dirent.h>
 
 namespace framegen {
@@ -16,70 +18,188 @@ void TimingController::init(Config& config) {
     state_.targetMs = ns_to_ms(config.max_frame_time_ns);
     state_.currentScale = config.model_scale;
     state_.currentQuality = config.quality;
+    state_.currentSearchRadius = SEARCH_RADII[std::size(SEARCH_RADII) - 1];
 
     LOGI("TimingController: Budget=%.2fms, Scale=%.2f, Quality=%.2f",
          state_.targetMs, state_.currentScale, state_.currentQuality);
 }
 
-bool TimingController::onFrameComplete(float frameTimeMs) {
+void TimingController::recordFrameTime(float frameTimeMs) {
+    // Track history — O(1) per frame
+    frameHistory_.push(frameTimeMs);
+
+    state_.avgMs = frameHistory_.mean();
+    state_.maxMs = frameHistory_.max();
+    state_.minMs = frameHistory_.min();
+    state_.p50Ms = frameHistory_.percentile(0.50f);
+    state_.p95Ms = frameHistory_.percentile(0.95f);
+    state_.p99Ms = frameHistory_.percentile(0.99f);
+}
+
+std::optional<TimingController::QualitySettings>
+TimingController::onPairComplete(const PairSample& sample) {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (sample.inputs.frames == 0) return std::nullopt;
 
-    // Track history
-    frameHistory_.push_back(frameTimeMs);
-    if (frameHistory_.size() > HISTORY_SIZE) {
-        frameHistory_.pop_front();
-    }
+    bool estimate = sample.estimateMs >= 0.0f;
+    float measuredMs = sample.synthesizeMs + (estimate ? sample.estimateMs : 0.0f);
 
-    // Calculate stats
-    state_.avgMs = std::accumulate(frameHistory_.begin(), frameHistory_.end(), 0.0f)
-                   / frameHistory_.size();
-    state_.maxMs = *std::max_element(frameHistory_.begin(), frameHistory_.end());
-    state_.minMs = *std::min_element(frameHistory_.begin(), frameHistory_.end());
-
-    bool overBudget = frameTimeMs > state_.targetMs;
-
-    // Consecutive tracking for hysteresis
-    if (overBudget) {
-        state_.consecutiveOverBudget++;
-        state_.consecutiveUnderBudget = 0;
-    } else {
-        state_.consecutiveUnderBudget++;
-        state_.consecutiveOverBudget = 0;
+    // How far off the model was, before it learns from this pair; the
+    // load follows a share of that error
+    if (modelsReady(estimate)) {
+        float predictedMs = predictPairMs(sample.inputs, estimate);
+        if (predictedMs > 0.0f) {
+            float ratio = measuredMs / predictedMs;
+            predictionRatios_.push(ratio);
+            state_.load = std::clamp(state_.load * std::pow(ratio, LOAD_GAIN), MIN_LOAD, MAX_LOAD);
+        }
     }
+    if (estimate) estimateModel_.observe(sample.inputs, sample.estimateMs / state_.load);
+    synthesizeModel_.observe(sample.inputs, sample.synthesizeMs / state_.load);
 
-    // Check thermal throttling
-    if (config_->thermal_protection) {
+    // A step up that held for a whole window was right; retry promptly
+    if (++pairsSinceChange_ == HISTORY_SIZE && lastStepUp_) stepUpWaitPairs_ = SETTLE_PAIRS;
+
+    recordFrameTime(measuredMs / sample.inputs.frames);
+
+    // Thermal zones are files; a few reads a second are plenty
+    if (config_ && config_->thermal_protection &&
+        ++pairsSinceThermalCheck_ >= THERMAL_CHECK_PAIRS) {
+        pairsSinceThermalCheck_ = 0;
         float temp = getGpuTemperature();
-        state_.throttled = (temp > 75.0f); // Throttle above 75°C
+        state_.throttled = (temp > 75.0f);
+        thermalCritical_ = (temp > 85.0f);
 
-        if (temp > 85.0f) {
-            // Critical — force minimum quality
-            state_.currentScale = 0.25f;
+        if (thermalCritical_) {
+            QualitySettings minimum{MODEL_SCALE_LADDER[0], SEARCH_RADII[0]};
             state_.currentQuality = 0.0f;
-            config_->model_scale = 0.25f;
             config_->quality = 0.0f;
             LOGW("TimingController: THERMAL CRITICAL (%.1f°C) — minimum quality", temp);
-            return false;
+            if (minimum.modelScale == state_.currentScale &&
+                minimum.searchRadius == state_.currentSearchRadius) {
+                return std::nullopt;
+            }
+            applySettings(minimum);
+            return minimum;
+        }
+    }
+    if (thermalCritical_) return std::nullopt;
+
+    auto settings = chooseSettings(sample);
+    if (settings) applySettings(*settings);
+    return settings;
+}
+
+bool TimingController::modelsReady(bool estimate) const {
+    return synthesizeModel_.samples() >= MIN_MODEL_SAMPLES &&
+           (!estimate || estimateModel_.samples() >= MIN_MODEL_SAMPLES);
+}
+
+float TimingController::predictPairMs(const CostModel::Inputs& inputs, bool estimate) const {
+    float ms = synthesizeModel_.predict(inputs);
+    if (estimate) ms += estimateModel_.predict(inputs);
+    return ms * state_.load;
+}
+
+std::optional<TimingController::QualitySettings>
+TimingController::chooseSettings(const PairSample& sample) {
+    bool estimate = sample.estimateMs >= 0.0f;
+    if (!modelsReady(estimate)) return std::nullopt;
+
+    float budgetMs = state_.targetMs * sample.inputs.frames * (1.0f - SAFETY_MARGIN);
+    if (state_.throttled) budgetMs *= THERMAL_HEADROOM;
+
+    // Predictions are scaled by how much worse than predicted the slow
+    // pairs have recently been
+    state_.tailFactor = predictionRatios_.count() >= MIN_DECISION_SAMPLES
+                        ? std::max(1.0f, predictionRatios_.percentile(0.95f)) : 1.0f;
+
+    // Candidates from cheapest to best: scale rung, then search radius
+    // (which only matters when estimating)
+    constexpr size_t RADII = std::size(SEARCH_RADII);
+    std::array<QualitySettings, MODEL_SCALE_RUNGS * RADII> candidates;
+    std::array<float, MODEL_SCALE_RUNGS * RADII> predictedMs;
+    size_t count = 0;
+    size_t current = 0;
+    float currentDistance = 0.0f;
+
+    for (float scale : MODEL_SCALE_LADDER) {
+        for (uint32_t radius : SEARCH_RADII) {
+            if (!estimate && radius != state_.currentSearchRadius) continue;
+
+            CostModel::Inputs inputs = sample.inputs;
+            inputs.modelScale = scale;
+            inputs.searchRadius = radius;
+            candidates[count] = {scale, radius};
+            predictedMs[count] = predictPairMs(inputs, estimate) * state_.tailFactor;
+
+            float distance = std::abs(scale - state_.currentScale) * 1000.0f +
+                             std::abs(static_cast<float>(radius) -
+                                      static_cast<float>(state_.currentSearchRadius));
+            if (count == 0 || distance < currentDistance) {
+                current = count;
+                currentDistance = distance;
+            }
+            count++;
         }
+    }
+    if (count == 0) return std::nullopt;  // Radius outside SEARCH_RADII
+    state_.predictedMs = predictedMs[current];
 
-        if (state_.throttled && state_.consecutiveOverBudget >= 3) {
-            adjustQuality(true);
-            return false;
+    // Best settings predicted to fit; the cheapest when none do
+    size_t best = 0;
+    for (size_t i = count; i-- > 0;) {
+        if (predictedMs[i] <= budgetMs) {
+            best = i;
+            break;
         }
     }
 
-    // Adaptive quality adjustment
-    if (state_.consecutiveOverBudget >= 5) {
-        adjustQuality(true);
-        return false;
+    size_t target = current;
+    if (best < current) {
+        target = best;
+    } else if (best > current && pairsSinceChange_ >= stepUpWaitPairs_) {
+        for (size_t i = current + 1; i <= best; i++) {
+            if (predictedMs[i] <= budgetMs * UPSCALE_HEADROOM) {
+                target = i;
+                break;
+            }
+        }
     }
+    if (target == current) return std::nullopt;
 
-    // Scale up if we have headroom
-    if (state_.consecutiveUnderBudget >= 30 && state_.avgMs < state_.targetMs * 0.7f) {
-        adjustQuality(false);
+    bool stepUp = target > current;
+    if (!stepUp && lastStepUp_ && pairsSinceChange_ < HISTORY_SIZE) {
+        stepUpWaitPairs_ = std::min(stepUpWaitPairs_ * 2, MAX_STEP_UP_WAIT);
     }
+    lastStepUp_ = stepUp;
+
+    LOGI("TimingController: %s Scale=%.2f Radius=%u (predicted %.2fms, was %.2fms, "
+         "budget %.2fms, tail x%.2f)",
+         stepUp ? "↑" : "↓", candidates[target].modelScale,
+         candidates[target].searchRadius, predictedMs[target], predictedMs[current],
+         budgetMs, state_.tailFactor);
+    return candidates[target];
+}
+
+void TimingController::setQuality(float quality) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_.currentQuality = std::clamp(quality, 0.0f, 1.0f);
+    applySettings({modelScaleForQuality(state_.currentQuality), state_.currentSearchRadius});
 
-    return !overBudget;
+    // Not a step of ours to back off from
+    lastStepUp_ = false;
+}
+
+void TimingController::applySettings(const QualitySettings& settings) {
+    state_.currentScale = settings.modelScale;
+    state_.currentSearchRadius = settings.searchRadius;
+    if (config_) config_->model_scale = settings.modelScale;
+
+    // Pairs already in flight report the old settings; the models take
+    // them as they are, the step-up wait lets them drain
+    pairsSinceChange_ = 0;
+    frameHistory_.reset();
 }
 
 float TimingController::getGpuTemperature() const {
@@ -141,32 +261,4 @@ float TimingController::readThermalZone(const char* path) const {
     return static_cast<float>(rawTemp);
 }
 
-void TimingController::adjustQuality(bool overBudget) {
-    if (overBudget) {
-        // Reduce quality
-        state_.currentScale = std::max(0.25f, state_.currentScale - 0.1f);
-        state_.currentQuality = std::max(0.0f, state_.currentQuality - 0.15f);
-
-        LOGI("TimingController: ↓ Scale=%.2f Quality=%.2f (avg=%.2fms, budget=%.2fms)",
-             state_.currentScale, state_.currentQuality, state_.avgMs, state_.targetMs);
-    } else {
-        // Increase quality (slower ramp-up than ramp-down)
-        state_.currentScale = std::min(0.75f, state_.currentScale + 0.05f);
-        state_.currentQuality = std::min(1.0f, state_.currentQuality + 0.05f);
-
-        LOGI("TimingController: ↑ Scale=%.2f Quality=%.2f (avg=%.2fms, budget=%.2fms)",
-             state_.currentScale, state_.currentQuality, state_.avgMs, state_.targetMs);
-    }
-
-    // Apply to config
-    if (config_) {
-        config_->model_scale = state_.currentScale;
-        config_->quality = state_.currentQuality;
-    }
-
-    // Reset counters
-    state_.consecutiveOverBudget = 0;
-    state_.consecutiveUnderBudget = 0;
-}
-
 } // namespace framegen
@@ -1,15 +1,31 @@
 /**
  * Timing Controller — manages frame pacing and adaptive quality.
  *
- * Monitors frame times and automatically adjusts quality settings
- * to maintain the target frame rate. Also handles thermal throttling.
+ * Per-stage timings of each pair (onPairComplete) feed a learned cost
+ * model: each stage's time is predicted for every scale rung and search
+ * radius, and the best settings whose predicted pair time (times the
+ * observed tail of prediction error) fits the budget with a margin are
+ * used. Moving down jumps straight to the target; moving up goes one step
+ * at a time once the pipeline has settled, so a model that is still
+ * learning cannot overshoot far. Also handles thermal throttling.
+ *
+ * Clocks, contention and thermals change the cost of every setting at
+ * once. Fitted at the current setting only, the models would learn such a
+ * change as that setting's cost alone and misjudge the others, so it is
+ * tracked as a separate load multiplier that follows prediction error
+ * within a few pairs, and the models learn load-normalized times.
+ *
+ * The frame-time window (avg, p50/p95/p99) restarts after each change,
+ * so it only describes frames at the current settings.
  */
 
 #pragma once
 
 #include "../framegen_types.h"
-#include <deque>
+#include "rolling_stats.h"
+#include "cost_model.h"
 #include <mutex>
+#include <optional>
 
 namespace framegen {
 
@@ -19,12 +35,6 @@ public:
 
     void init(Config& config);
 
-    /**
-     * Called after each frame is processed. Returns true if we're on budget.
-     * If false, the controller has already adjusted quality settings.
-     */
-    bool onFrameComplete(float frameTimeMs);
-
     /**
      * Get the current GPU temperature (Celsius).
      * Reads from /sys/class/thermal/ on Android.
@@ -42,17 +52,49 @@ public:
     struct AdaptiveState {
         float currentScale = 0.5f;  // Current model resolution scale
         float currentQuality = 0.5f;
+        uint32_t currentSearchRadius = 16;
         float targetMs = 8.0f;       // Target frame time
         float avgMs = 0.0f;
         float maxMs = 0.0f;
         float minMs = 999.0f;
+        float p50Ms = 0.0f;
+        float p95Ms = 0.0f;
+        float p99Ms = 0.0f;
+        float predictedMs = 0.0f;   // Cost model's pair time at the current settings
+        float tailFactor = 1.0f;    // p95 of measured / predicted
+        float load = 1.0f;          // Device-wide cost multiplier on the models
         bool throttled = false;
-        int consecutiveOverBudget = 0;
-        int consecutiveUnderBudget = 0;
     };
 
     const AdaptiveState& getState() const { return state_; }
 
+    // What onPairComplete() chooses between; applied by the caller
+    struct QualitySettings {
+        float modelScale = 0.5f;
+        uint32_t searchRadius = 16;
+    };
+
+    // One pair's measured stage times and the settings it ran with
+    struct PairSample {
+        CostModel::Inputs inputs;
+        float estimateMs = -1.0f;   // Negative: no motion estimation (interpolating)
+        float synthesizeMs = 0.0f;
+    };
+
+    /**
+     * Called after each pair that generated frames. The budget is
+     * targetMs per generated frame, for estimation and synthesis together.
+     * @return New settings to apply, if they changed
+     */
+    std::optional<QualitySettings> onPairComplete(const PairSample& sample);
+
+    /**
+     * The user picked a quality (0.0-1.0): its rung, as RifeEngine::
+     * setQuality() selects it, becomes the current scale, and adaptation
+     * continues from there.
+     */
+    void setQuality(float quality);
+
     // Manual overrides
     void setTargetMs(float ms) { state_.targetMs = ms; }
     void setBudget(uint64_t ns) { state_.targetMs = ns_to_ms(ns); }
@@ -60,12 +102,53 @@ public:
 private:
     Config* config_ = nullptr;
     AdaptiveState state_;
-    std::deque<float> frameHistory_;
     static constexpr size_t HISTORY_SIZE = 60;
+    RollingStats<HISTORY_SIZE> frameHistory_;
     mutable std::mutex mutex_;
 
+    // Prediction ratios before their p95 is trusted
+    static constexpr size_t MIN_DECISION_SAMPLES = 16;
+
+    // Cost model state (onPairComplete)
+    CostModel estimateModel_{CostModel::Stage::ESTIMATE};
+    CostModel synthesizeModel_{CostModel::Stage::SYNTHESIZE};
+    // Measured / predicted pair time; not reset with the settings, and
+    // longer than the frame window so its p95 is steady
+    static constexpr size_t RATIO_HISTORY_SIZE = 240;
+    RollingStats<RATIO_HISTORY_SIZE> predictionRatios_;
+    uint32_t pairsSinceChange_ = 0;
+    uint32_t pairsSinceThermalCheck_ = 0;
+
+    // Pairs to hold before stepping up; doubles whenever a step up is
+    // undone within a window, so a borderline rung is retried ever more
+    // rarely instead of flapping
+    uint32_t stepUpWaitPairs_ = SETTLE_PAIRS;
+    bool lastStepUp_ = false;
+    bool thermalCritical_ = false;
+
+    static constexpr uint32_t SEARCH_RADII[] = {8, 12, 16};
+    static constexpr size_t MIN_MODEL_SAMPLES = 8;      // Per stage, before it is trusted
+    static constexpr uint32_t SETTLE_PAIRS = 4;         // In flight at the old settings
+    static constexpr uint32_t MAX_STEP_UP_WAIT = 512;
+    static constexpr float SAFETY_MARGIN = 0.1f;        // Of the budget
+    static constexpr float UPSCALE_HEADROOM = 0.9f;     // Extra margin to step up
+    static constexpr float THERMAL_HEADROOM = 0.8f;     // Budget share while throttled
+    static constexpr uint32_t THERMAL_CHECK_PAIRS = 16;
+
     float readThermalZone(const char* path) const;
-    void adjustQuality(bool overBudget);
+
+    void recordFrameTime(float frameTimeMs);
+
+    // Share of a pair's prediction error (in log space) the load takes
+    static constexpr float LOAD_GAIN = 0.3f;
+    static constexpr float MIN_LOAD = 0.25f;
+    static constexpr float MAX_LOAD = 8.0f;
+
+    // Estimation + synthesis time of a pair, per the cost models and load
+    bool modelsReady(bool estimate) const;
+    float predictPairMs(const CostModel::Inputs& inputs, bool estimate) const;
+    std::optional<QualitySettings> chooseSettings(const PairSample& sample);
+    void applySettings(const QualitySettings& settings);
 };
 
 } // namespace framegen
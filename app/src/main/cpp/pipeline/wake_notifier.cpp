@@ -0,0 +1,80 @@
+/**
+ * Wake Notifier implementation — futex on Linux/Android
+ */
+
+#include "wake_notifier.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace framegen {
+
+#if defined(__linux__)
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+static long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+#endif
+
+void WakeNotifier::notify() {
+    // The epoch bump makes a racing wait() return at once; the fence
+    // pairs with the one in prepareWait() so that either the consumer
+    // sees the published work or we see it parked. Claiming the parked
+    // flag means a burst of pushes wakes it once.
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed) == 0 ||
+        parked_.exchange(0, std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    wakeCalls_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    futex(&epoch_, FUTEX_WAKE_PRIVATE, 1, nullptr);
+#endif
+}
+
+uint32_t WakeNotifier::prepareWait() {
+    parked_.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+}
+
+void WakeNotifier::cancelWait() {
+    parked_.store(0, std::memory_order_relaxed);
+}
+
+bool WakeNotifier::wait(uint32_t key, uint64_t timeoutNs) {
+    parks_.fetch_add(1, std::memory_order_relaxed);
+    bool woken = true;
+
+#if defined(__linux__)
+    timespec timeout{};
+    timeout.tv_sec = static_cast<time_t>(timeoutNs / 1'000'000'000ULL);
+    timeout.tv_nsec = static_cast<long>(timeoutNs % 1'000'000'000ULL);
+
+    // EAGAIN: epoch already moved on — a notify raced us, nothing to wait for
+    if (futex(&epoch_, FUTEX_WAIT_PRIVATE, key, &timeout) != 0 && errno == ETIMEDOUT) {
+        woken = false;
+    }
+#else
+    // No futex: bounded sleep, as the presenter polled before
+    uint64_t slept = std::min<uint64_t>(timeoutNs, 500'000);
+    std::this_thread::sleep_for(std::chrono::nanoseconds(slept));
+    woken = epoch_.load(std::memory_order_seq_cst) != key;
+#endif
+
+    parked_.store(0, std::memory_order_relaxed);
+    return woken;
+}
+
+} // namespace framegen
@@ -0,0 +1,52 @@
+/**
+ * Wake Notifier — futex-backed wakeups for the SPSC frame queues.
+ *
+ * The consumer parks on a futex only after announcing it and re-checking
+ * its queue; the producer bumps an epoch after publishing and issues
+ * FUTEX_WAKE only when the consumer is actually parked. An idle pipeline
+ * costs no wakeups at all, and a busy one costs no syscalls on the
+ * producer side.
+ *
+ * Consumer protocol:
+ *   uint32_t key = notifier.prepareWait();
+ *   if (work available) notifier.cancelWait(); else notifier.wait(key, timeout);
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+
+namespace framegen {
+
+class WakeNotifier {
+public:
+    WakeNotifier() = default;
+    WakeNotifier(const WakeNotifier&) = delete;
+    WakeNotifier& operator=(const WakeNotifier&) = delete;
+
+    // Producer: call after publishing. Syscall only if the consumer is parked.
+    void notify();
+
+    // Consumer: announce the intent to park; re-check for work afterwards
+    uint32_t prepareWait();
+    void cancelWait();
+
+    /**
+     * Park until notify() or timeoutNs. Returns immediately if a notify
+     * happened since prepareWait() returned key.
+     * @return false on timeout
+     */
+    bool wait(uint32_t key, uint64_t timeoutNs);
+
+    // Wake syscalls issued / times the consumer actually slept
+    uint64_t wakeCalls() const { return wakeCalls_.load(std::memory_order_relaxed); }
+    uint64_t parks() const { return parks_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> epoch_{0};    // Futex word
+    std::atomic<uint32_t> parked_{0};
+    std::atomic<uint64_t> wakeCalls_{0};
+    std::atomic<uint64_t> parks_{0};
+};
+
+} // namespace framegen
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+INT8 calibration — quantizes the RIFE model from representative replay frames.
+
+Takes a directory of consecutive captured frames (PNG, sorted by name),
+splits the consecutive pairs into a calibration set and a held-out guard
+set, and:
+  - writes the calibration pairs as .npy blobs (fp32 CHW in [0,1], the
+    layout rife_preprocess.comp produces) plus one timestep blob per pair
+  - runs NCNN's ncnn2table (KL calibration) and ncnn2int8 on them
+  - writes the guard pairs as rife-guard.rgb, which RifeEngine uses to
+    check INT8 output against FP16 (PSNR) on the device
+
+The outputs are meant to be packed next to the FP16 model:
+  pack_bundle.py --output framegen.bundle rife-v4.6-lite.param rife-v4.6-lite.bin \\
+      rife-v4.6-lite-int8.param rife-v4.6-lite-int8.bin rife-guard.rgb
+
+Requires numpy, Pillow and the NCNN tools (ncnn2table, ncnn2int8) on PATH
+or in --ncnn-tools.
+
+Usage: calibrate_int8.py --frames replay/ --model rife-v4.6-lite --output-dir out/
+"""
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+
+GUARD_MAGIC = b"FGRG"
+GUARD_HEADER = struct.Struct("<4sIII")  # magic, width, height, pair count
+
+FRAME_SUFFIXES = (".png",)
+
+
+def parse_size(text):
+    w, h = text.lower().split("x")
+    return int(w), int(h)
+
+
+def load_frames(directory):
+    names = sorted(n for n in os.listdir(directory) if n.lower().endswith(FRAME_SUFFIXES))
+    if len(names) < 2:
+        raise ValueError("%s: need at least two frames" % directory)
+    return [os.path.join(directory, n) for n in names]
+
+
+def split_pairs(frames, guard_pairs):
+    """Consecutive pairs; every k-th pair is held out for the guard set."""
+    pairs = list(zip(frames[:-1], frames[1:]))
+    if guard_pairs <= 0:
+        return pairs, []
+    stride = max(2, len(pairs) // guard_pairs)
+    guard = pairs[stride // 2::stride][:guard_pairs]
+    held = set(guard)
+    return [p for p in pairs if p not in held], guard
+
+
+def find_tool(name, tools_dir):
+    if tools_dir:
+        path = os.path.join(tools_dir, name)
+        if os.access(path, os.X_OK):
+            return path
+    path = shutil.which(name)
+    if not path:
+        raise ValueError("%s not found (pass --ncnn-tools)" % name)
+    return path
+
+
+def write_calibration_set(pairs, size, timestep, work_dir):
+    import numpy as np
+    from PIL import Image
+
+    # Pad like the pre-pass: model resolution rounded up to 32, zero-filled
+    width, height = size
+    padded_w = (width + 31) // 32 * 32
+    padded_h = (height + 31) // 32 * 32
+
+    def blob(path):
+        img = Image.open(path).convert("RGB").resize((width, height), Image.BILINEAR)
+        chw = np.asarray(img, dtype=np.float32).transpose(2, 0, 1) / 255.0
+        out = np.zeros((3, padded_h, padded_w), dtype=np.float32)
+        out[:, :height, :width] = chw
+        return out
+
+    lists = [[], [], []]
+    for i, (first, second) in enumerate(pairs):
+        blobs = (blob(first), blob(second), np.array([timestep], dtype=np.float32))
+        for slot, data in enumerate(blobs):
+            path = os.path.join(work_dir, "pair%05d_in%d.npy" % (i, slot))
+            np.save(path, data)
+            lists[slot].append(path)
+
+    list_paths = []
+    for slot, entries in enumerate(lists):
+        path = os.path.join(work_dir, "input%d.txt" % slot)
+        with open(path, "w") as f:
+            f.write("\n".join(entries) + "\n")
+        list_paths.append(path)
+    return list_paths, (padded_w, padded_h)
+
+
+def write_guard_set(pairs, size, output):
+    from PIL import Image
+
+    width, height = size
+    with open(output, "wb") as f:
+        f.write(GUARD_HEADER.pack(GUARD_MAGIC, width, height, len(pairs)))
+        for pair in pairs:
+            for path in pair:
+                img = Image.open(path).convert("RGB").resize((width, height), Image.BILINEAR)
+                f.write(img.tobytes())
+
+
+def run(cmd):
+    print("+ " + " ".join(cmd))
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--frames", required=True, help="directory of consecutive replay frames")
+    parser.add_argument("--model", required=True, help="FP16 model path without extension")
+    parser.add_argument("--output-dir", required=True)
+    parser.add_argument("--ncnn-tools", help="directory containing ncnn2table and ncnn2int8")
+    parser.add_argument("--size", type=parse_size, default=(960, 540),
+                        help="calibration model resolution (default 960x540)")
+    parser.add_argument("--guard-size", type=parse_size, default=(480, 270),
+                        help="resolution the guard set is stored at (default 480x270)")
+    parser.add_argument("--guard-pairs", type=int, default=4)
+    parser.add_argument("--timestep", type=float, default=0.5)
+    parser.add_argument("--method", choices=("kl", "aciq", "eq"), default="kl")
+    parser.add_argument("--threads", type=int, default=os.cpu_count() or 4)
+    args = parser.parse_args()
+
+    try:
+        frames = load_frames(args.frames)
+        calibration, guard = split_pairs(frames, args.guard_pairs)
+        if not calibration:
+            raise ValueError("no pairs left for calibration")
+
+        ncnn2table = find_tool("ncnn2table", args.ncnn_tools)
+        ncnn2int8 = find_tool("ncnn2int8", args.ncnn_tools)
+
+        os.makedirs(args.output_dir, exist_ok=True)
+        work_dir = os.path.join(args.output_dir, "calibration")
+        os.makedirs(work_dir, exist_ok=True)
+
+        lists, (padded_w, padded_h) = write_calibration_set(
+            calibration, args.size, args.timestep, work_dir)
+
+        base = os.path.basename(args.model)
+        table = os.path.join(args.output_dir, base + ".table")
+        int8_base = os.path.join(args.output_dir, base + "-int8")
+
+        run([ncnn2table, args.model + ".param", args.model + ".bin", ",".join(lists), table,
+             "shape=[%d,%d,3],[%d,%d,3],[1]" % (padded_w, padded_h, padded_w, padded_h),
+             "thread=%d" % args.threads, "method=%s" % args.method])
+        run([ncnn2int8, args.model + ".param", args.model + ".bin",
+             int8_base + ".param", int8_base + ".bin", table])
+
+        guard_path = os.path.join(args.output_dir, "rife-guard.rgb")
+        write_guard_set(guard, args.guard_size, guard_path)
+    except (ValueError, OSError, subprocess.CalledProcessError) as e:
+        sys.stderr.write("calibrate_int8: %s\n" % e)
+        return 1
+    except ImportError as e:
+        sys.stderr.write("calibrate_int8: %s (pip install numpy pillow)\n" % e)
+        return 1
+
+    print("calibrated on %d pairs, %d guard pairs -> %s" % (
+        len(calibration), len(guard), args.output_dir))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+"""
+Shader registry generator — embeds SPIR-V blobs into C++ and reflects
+their interface so descriptor layouts never have to be written by hand.
+
+For every .spv given on the command line this emits:
+  - the SPIR-V words as a constexpr uint32_t array
+  - the descriptor set layout bindings (set 0)
+  - the push-constant block size
+  - the workgroup size (LocalSize execution mode)
+
+and one ShaderInfo table consumed by utils/shader_registry.cpp.
+
+Usage: gen_shader_registry.py --output shader_registry_data.cpp a.spv b.spv ...
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+SPIRV_MAGIC = 0x07230203
+
+# Opcodes
+OP_EXECUTION_MODE = 16
+OP_TYPE_BOOL = 20
+OP_TYPE_INT = 21
+OP_TYPE_FLOAT = 22
+OP_TYPE_VECTOR = 23
+OP_TYPE_MATRIX = 24
+OP_TYPE_IMAGE = 25
+OP_TYPE_SAMPLER = 26
+OP_TYPE_SAMPLED_IMAGE = 27
+OP_TYPE_ARRAY = 28
+OP_TYPE_RUNTIME_ARRAY = 29
+OP_TYPE_STRUCT = 30
+OP_TYPE_POINTER = 32
+OP_CONSTANT = 43
+OP_VARIABLE = 59
+OP_DECORATE = 71
+OP_MEMBER_DECORATE = 72
+
+# Execution modes
+MODE_LOCAL_SIZE = 17
+MODE_LOCAL_SIZE_ID = 38
+
+# Decorations
+DEC_BUFFER_BLOCK = 3
+DEC_ARRAY_STRIDE = 6
+DEC_MATRIX_STRIDE = 7
+DEC_BINDING = 33
+DEC_DESCRIPTOR_SET = 34
+DEC_OFFSET = 35
+
+# Storage classes
+SC_UNIFORM_CONSTANT = 0
+SC_UNIFORM = 2
+SC_PUSH_CONSTANT = 9
+SC_STORAGE_BUFFER = 12
+
+DIM_BUFFER = 5
+
+
+class Module:
+    def __init__(self, words):
+        if len(words) < 5 or words[0] != SPIRV_MAGIC:
+            raise ValueError("not a SPIR-V module")
+
+        self.types = {}        # id -> (opcode, operands)
+        self.constants = {}    # id -> literal value
+        self.variables = []    # (type id, result id, storage class)
+        self.decorations = {}  # id -> {decoration: [literals]}
+        self.member_offsets = {}   # struct id -> {member: offset}
+        self.member_strides = {}   # struct id -> {member: matrix stride}
+        self.local_size = [1, 1, 1]
+        local_size_ids = None
+
+        i = 5
+        while i < len(words):
+            count = words[i] >> 16
+            opcode = words[i] & 0xFFFF
+            if count == 0:
+                raise ValueError("malformed instruction at word %d" % i)
+            ops = words[i + 1:i + count]
+
+            if OP_TYPE_BOOL <= opcode <= OP_TYPE_POINTER:
+                self.types[ops[0]] = (opcode, ops[1:])
+            elif opcode == OP_CONSTANT:
+                self.constants[ops[1]] = ops[2]
+            elif opcode == OP_VARIABLE:
+                self.variables.append((ops[0], ops[1], ops[2]))
+            elif opcode == OP_DECORATE:
+                self.decorations.setdefault(ops[0], {})[ops[1]] = ops[2:]
+            elif opcode == OP_MEMBER_DECORATE:
+                if ops[2] == DEC_OFFSET:
+                    self.member_offsets.setdefault(ops[0], {})[ops[1]] = ops[3]
+                elif ops[2] == DEC_MATRIX_STRIDE:
+                    self.member_strides.setdefault(ops[0], {})[ops[1]] = ops[3]
+            elif opcode == OP_EXECUTION_MODE:
+                if ops[1] == MODE_LOCAL_SIZE:
+                    self.local_size = list(ops[2:5])
+                elif ops[1] == MODE_LOCAL_SIZE_ID:
+                    local_size_ids = list(ops[2:5])
+
+            i += count
+
+        if local_size_ids:
+            self.local_size = [self.constants.get(x, 1) for x in local_size_ids]
+
+    def decoration(self, target, dec):
+        return self.decorations.get(target, {}).get(dec)
+
+    def type_size(self, type_id, matrix_stride=None):
+        opcode, ops = self.types[type_id]
+        if opcode in (OP_TYPE_INT, OP_TYPE_FLOAT):
+            return ops[0] // 8
+        if opcode == OP_TYPE_BOOL:
+            return 4
+        if opcode == OP_TYPE_VECTOR:
+            return self.type_size(ops[0]) * ops[1]
+        if opcode == OP_TYPE_MATRIX:
+            columns = ops[1]
+            stride = matrix_stride or self.type_size(ops[0])
+            return stride * columns
+        if opcode == OP_TYPE_ARRAY:
+            stride = self.decoration(type_id, DEC_ARRAY_STRIDE)
+            length = self.constants[ops[1]]
+            return (stride[0] if stride else self.type_size(ops[0])) * length
+        if opcode == OP_TYPE_STRUCT:
+            offsets = self.member_offsets.get(type_id, {})
+            strides = self.member_strides.get(type_id, {})
+            size = 0
+            for member, member_type in enumerate(ops):
+                end = offsets.get(member, size) + self.type_size(member_type, strides.get(member))
+                size = max(size, end)
+            return size
+        raise ValueError("cannot size type opcode %d" % opcode)
+
+    def descriptor(self, type_id, storage_class):
+        """Returns (VkDescriptorType name, descriptor count) for a resource type."""
+        count = 1
+        opcode, ops = self.types[type_id]
+        while opcode in (OP_TYPE_ARRAY, OP_TYPE_RUNTIME_ARRAY):
+            if opcode == OP_TYPE_ARRAY:
+                count *= self.constants[ops[1]]
+            type_id = ops[0]
+            opcode, ops = self.types[type_id]
+
+        if opcode == OP_TYPE_SAMPLED_IMAGE:
+            image_op, image_ops = self.types[ops[0]]
+            if image_ops[1] == DIM_BUFFER:
+                return "VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER", count
+            return "VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER", count
+        if opcode == OP_TYPE_IMAGE:
+            dim, sampled = ops[1], ops[5]
+            if dim == DIM_BUFFER:
+                return ("VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER" if sampled == 2
+                        else "VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER"), count
+            return ("VK_DESCRIPTOR_TYPE_STORAGE_IMAGE" if sampled == 2
+                    else "VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE"), count
+        if opcode == OP_TYPE_SAMPLER:
+            return "VK_DESCRIPTOR_TYPE_SAMPLER", count
+        if opcode == OP_TYPE_STRUCT:
+            if storage_class == SC_STORAGE_BUFFER or self.decoration(type_id, DEC_BUFFER_BLOCK) is not None:
+                return "VK_DESCRIPTOR_TYPE_STORAGE_BUFFER", count
+            return "VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER", count
+        raise ValueError("unsupported descriptor type opcode %d" % opcode)
+
+    def reflect(self):
+        bindings = []
+        push_constant_size = 0
+
+        for ptr_type, var_id, storage_class in self.variables:
+            pointee = self.types[ptr_type][1][1]
+
+            if storage_class == SC_PUSH_CONSTANT:
+                push_constant_size = max(push_constant_size, self.type_size(pointee))
+                continue
+
+            if storage_class not in (SC_UNIFORM_CONSTANT, SC_UNIFORM, SC_STORAGE_BUFFER):
+                continue
+
+            binding = self.decoration(var_id, DEC_BINDING)
+            if binding is None:
+                continue
+            desc_set = self.decoration(var_id, DEC_DESCRIPTOR_SET)
+            if desc_set and desc_set[0] != 0:
+                raise ValueError("only descriptor set 0 is supported (binding %d)" % binding[0])
+
+            desc_type, count = self.descriptor(pointee, storage_class)
+            bindings.append((binding[0], desc_type, count))
+
+        bindings.sort()
+        return bindings, push_constant_size
+
+
+def c_identifier(name):
+    return "".join(c if c.isalnum() else "_" for c in name)
+
+
+def generate(spv_paths):
+    out = []
+    out.append("// Generated by tools/gen_shader_registry.py — do not edit.")
+    out.append("")
+    out.append('#include "shader_registry.h"')
+    out.append("")
+    out.append("namespace framegen {")
+    out.append("")
+    out.append("namespace {")
+
+    entries = []
+    for path in sorted(spv_paths, key=os.path.basename):
+        name = os.path.splitext(os.path.basename(path))[0]
+        ident = c_identifier(name)
+
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) % 4:
+            raise ValueError("%s: size is not a multiple of 4" % path)
+        words = list(struct.unpack("<%dI" % (len(data) // 4), data))
+
+        module = Module(words)
+        bindings, push_size = module.reflect()
+
+        out.append("")
+        out.append("// %s: %d bindings, %d push-constant bytes, local size %dx%dx%d" % (
+            name, len(bindings), push_size, *module.local_size))
+        out.append("alignas(4) constexpr uint32_t %s_spv[] = {" % ident)
+        for i in range(0, len(words), 8):
+            out.append("    " + ", ".join("0x%08xu" % w for w in words[i:i + 8]) + ",")
+        out.append("};")
+
+        if bindings:
+            out.append("constexpr VkDescriptorSetLayoutBinding %s_bindings[] = {" % ident)
+            for binding, desc_type, count in bindings:
+                out.append("    {%d, %s, %d, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}," % (
+                    binding, desc_type, count))
+            out.append("};")
+
+        entries.append((name, ident, len(bindings), push_size, module.local_size))
+
+    out.append("")
+    out.append("} // namespace")
+    out.append("")
+    out.append("const ShaderInfo EMBEDDED_SHADERS[] = {")
+    for name, ident, binding_count, push_size, local in entries:
+        out.append('    {"%s", %s_spv, sizeof(%s_spv),' % (name, ident, ident))
+        out.append("     %s, %d, %d, {%d, %d, %d}}," % (
+            "%s_bindings" % ident if binding_count else "nullptr",
+            binding_count, push_size, *local))
+    if not entries:
+        out.append("    {nullptr, nullptr, 0, nullptr, 0, 0, {0, 0, 0}},")
+    out.append("};")
+    out.append("")
+    out.append("const size_t EMBEDDED_SHADER_COUNT = %d;" % len(entries))
+    out.append("")
+    out.append("} // namespace framegen")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--output", required=True)
+    parser.add_argument("spirv", nargs="*")
+    args = parser.parse_args()
+
+    try:
+        source = generate(args.spirv)
+    except (ValueError, KeyError) as e:
+        sys.stderr.write("gen_shader_registry: %s\n" % e)
+        return 1
+
+    with open(args.output, "w") as f:
+        f.write(source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Asset bundle packer — writes the single-file, page-aligned bundle read by
+utils/asset_bundle.cpp.
+
+Each input file becomes one entry named after its basename. Text payloads
+(.param) get a trailing NUL so they can be parsed in place.
+
+Usage: pack_bundle.py --output framegen.bundle rife-v4.6-lite.param rife-v4.6-lite.bin ...
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"FGBUNDLE"
+VERSION = 1
+ALIGNMENT = 16384  # Page aligned on 4 KiB and 16 KiB page kernels
+
+HEADER = struct.Struct("<8sIIIIQ32s")   # BundleHeader, 64 bytes
+ENTRY = struct.Struct("<64sQQII8s")     # BundleEntry, 96 bytes
+
+TEXT_SUFFIXES = (".param",)
+
+
+def align(value):
+    return (value + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def pack(paths, output):
+    payloads = []
+    for path in paths:
+        name = os.path.basename(path)
+        if len(name.encode()) >= 64:
+            raise ValueError("entry name too long: %s" % name)
+        with open(path, "rb") as f:
+            data = f.read()
+        if name.endswith(TEXT_SUFFIXES):
+            data += b"\0"
+        payloads.append((name, data))
+
+    if len({name for name, _ in payloads}) != len(payloads):
+        raise ValueError("duplicate entry names")
+
+    offset = align(HEADER.size + ENTRY.size * len(payloads))
+    index = b""
+    layout = []
+    for name, data in payloads:
+        index += ENTRY.pack(name.encode(), offset, len(data), zlib.crc32(data), 0, b"")
+        layout.append((offset, data))
+        offset = align(offset + len(data))
+
+    file_size = layout[-1][0] + len(layout[-1][1]) if layout else HEADER.size
+    header = HEADER.pack(MAGIC, VERSION, len(payloads), ALIGNMENT,
+                         zlib.crc32(index), file_size, b"")
+
+    with open(output, "wb") as f:
+        f.write(header)
+        f.write(index)
+        for offset, data in layout:
+            f.seek(offset)
+            f.write(data)
+
+    for (name, data), (offset, _) in zip(payloads, layout):
+        print("  %-32s %10d bytes @ %d" % (name, len(data), offset))
+    print("%s: %d entries, %d bytes" % (output, len(payloads), file_size))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--output", required=True)
+    parser.add_argument("files", nargs="+")
+    args = parser.parse_args()
+
+    try:
+        pack(args.files, args.output)
+    except (OSError, ValueError) as e:
+        sys.stderr.write("pack_bundle: %s\n" % e)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,136 @@
+/**
+ * Asset Bundle implementation
+ */
+
+#include "asset_bundle.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace framegen {
+
+AssetBundle::~AssetBundle() {
+    close();
+}
+
+bool AssetBundle::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGI("AssetBundle: No bundle at %s", path.c_str());
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(BundleHeader))) {
+        LOGE("AssetBundle: %s is too small", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        LOGE("AssetBundle: mmap failed for %s", path.c_str());
+        return false;
+    }
+
+    base_ = static_cast<const uint8_t*>(mapped);
+    size_ = size;
+    header_ = reinterpret_cast<const BundleHeader*>(base_);
+
+    if (memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 || header_->version != VERSION ||
+        header_->alignment == 0 || (header_->alignment & (header_->alignment - 1)) != 0) {
+        LOGE("AssetBundle: %s is not a v%u bundle", path.c_str(), VERSION);
+        close();
+        return false;
+    }
+
+    size_t indexBytes = static_cast<size_t>(header_->entryCount) * sizeof(BundleEntry);
+    if (header_->fileSize != size_ || sizeof(BundleHeader) + indexBytes > size_) {
+        LOGE("AssetBundle: %s is truncated", path.c_str());
+        close();
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const BundleEntry*>(base_ + sizeof(BundleHeader));
+    if (crc32(reinterpret_cast<const uint8_t*>(entries_), indexBytes) != header_->indexCrc) {
+        LOGE("AssetBundle: %s index checksum mismatch", path.c_str());
+        close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header_->entryCount; i++) {
+        const BundleEntry& e = entries_[i];
+        bool terminated = memchr(e.name, '\0', sizeof(e.name)) != nullptr;
+        if (!terminated || e.offset % header_->alignment != 0 ||
+            e.offset > size_ || e.size > size_ - e.offset) {
+            LOGE("AssetBundle: %s has a corrupt entry %u", path.c_str(), i);
+            close();
+            return false;
+        }
+    }
+
+    LOGI("AssetBundle: Mapped %s (%u entries, %zu bytes)",
+         path.c_str(), header_->entryCount, size_);
+    return true;
+}
+
+void AssetBundle::close() {
+    if (base_) {
+        munmap(const_cast<uint8_t*>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    entries_ = nullptr;
+}
+
+const BundleEntry* AssetBundle::find(const std::string& name) const {
+    if (!base_) return nullptr;
+
+    for (uint32_t i = 0; i < header_->entryCount; i++) {
+        if (name == entries_[i].name) return &entries_[i];
+    }
+    return nullptr;
+}
+
+bool AssetBundle::verify(const BundleEntry& entry) const {
+    if (crc32(data(entry), entry.size) != entry.crc32) {
+        LOGE("AssetBundle: Checksum mismatch for %s", entry.name);
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::prefetch(const BundleEntry& entry) const {
+    // Offsets are page aligned, so the range start is too
+    madvise(const_cast<uint8_t*>(data(entry)), entry.size, MADV_WILLNEED);
+}
+
+uint32_t AssetBundle::crc32(const uint8_t* data, size_t size) {
+    // Reflected CRC-32 (IEEE 802.3), matches zlib.crc32
+    static const auto table = [] {
+        struct { uint32_t v[256]; } t{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t.v[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.v[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+} // namespace framegen
@@ -0,0 +1,83 @@
+/**
+ * Asset Bundle — read-only, memory-mapped single-file container for
+ * model files.
+ *
+ * Layout (little-endian, written by tools/pack_bundle.py):
+ *   BundleHeader
+ *   BundleEntry[entryCount]       index, CRC32 in header.indexCrc
+ *   payloads                      each at a multiple of header.alignment
+ *
+ * The file is mmapped once; consumers read payloads in place, so model
+ * weights are clean file-backed pages the kernel can evict and re-read
+ * instead of heap copies. Payload alignment is 16 KiB, which is page
+ * aligned on both 4 KiB and 16 KiB page kernels.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <string>
+
+namespace framegen {
+
+struct BundleHeader {
+    char magic[8];          // "FGBUNDLE"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;     // Payload alignment in bytes
+    uint32_t indexCrc;      // CRC32 of the entry table
+    uint64_t fileSize;
+    uint8_t reserved[32];
+};
+static_assert(sizeof(BundleHeader) == 64, "BundleHeader layout");
+
+struct BundleEntry {
+    char name[64];          // NUL-terminated, e.g. "rife-v4.6-lite.bin"
+    uint64_t offset;        // From start of file, multiple of alignment
+    uint64_t size;          // Bytes (text payloads include a trailing NUL)
+    uint32_t crc32;         // CRC32 of the payload
+    uint32_t flags;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(BundleEntry) == 96, "BundleEntry layout");
+
+class AssetBundle {
+public:
+    static constexpr char MAGIC[8] = {'F', 'G', 'B', 'U', 'N', 'D', 'L', 'E'};
+    static constexpr uint32_t VERSION = 1;
+
+    AssetBundle() = default;
+    ~AssetBundle();
+
+    AssetBundle(const AssetBundle&) = delete;
+    AssetBundle& operator=(const AssetBundle&) = delete;
+
+    /**
+     * Map a bundle and validate its header and index. Payload checksums
+     * are checked by verify(), when an entry is first used.
+     */
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // nullptr if the bundle has no entry with this name
+    const BundleEntry* find(const std::string& name) const;
+
+    const uint8_t* data(const BundleEntry& entry) const { return base_ + entry.offset; }
+
+    // Check the payload CRC32 (touches every page of the entry)
+    bool verify(const BundleEntry& entry) const;
+
+    // Hint that an entry is about to be read sequentially
+    void prefetch(const BundleEntry& entry) const;
+
+    static uint32_t crc32(const uint8_t* data, size_t size);
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    const BundleHeader* header_ = nullptr;
+    const BundleEntry* entries_ = nullptr;
+};
+
+} // namespace framegen
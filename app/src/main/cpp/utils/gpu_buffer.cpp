@@ -30,6 +30,13 @@ bool GpuBuffer::create(VkDevice device, VkPhysicalDevice physicalDevice,
                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
             break;
 
+        case Type::READBACK:
+            // Uncached host memory makes CPU reads crawl on mobile GPUs
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | extraUsage;
+            memFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                       VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            break;
+
         case Type::DEVICE:
             bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
                                VK_BUFFER_USAGE_TRANSFER_DST_BIT | extraUsage;
@@ -104,6 +111,15 @@ void GpuBuffer::flush(VkDeviceSize offset, VkDeviceSize size) {
     vkFlushMappedMemoryRanges(device_, 1, &range);
 }
 
+void GpuBuffer::invalidate(VkDeviceSize offset, VkDeviceSize size) {
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = memory_;
+    range.offset = offset;
+    range.size = size;
+    vkInvalidateMappedMemoryRanges(device_, 1, &range);
+}
+
 uint32_t GpuBuffer::findMemoryType(VkPhysicalDevice physicalDevice,
                                     uint32_t typeFilter, VkMemoryPropertyFlags properties) {
     VkPhysicalDeviceMemoryProperties memProps;
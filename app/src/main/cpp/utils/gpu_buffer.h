@@ -12,6 +12,7 @@ class GpuBuffer {
 public:
     enum class Type {
         STAGING,    // CPU-visible, for transfers
+        READBACK,   // CPU-visible and cached, for GPU -> CPU copies
         DEVICE,     // GPU-only, fastest
         UNIFORM,    // Small, frequently updated
     };
@@ -27,6 +28,8 @@ public:
     void* map();
     void unmap();
     void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+    // Make GPU writes visible to a mapped READBACK buffer
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
 
     VkBuffer buffer() const { return buffer_; }
     VkDeviceMemory memory() const { return memory_; }
@@ -0,0 +1,19 @@
+/**
+ * Shader Registry implementation
+ */
+
+#include "shader_registry.h"
+
+namespace framegen {
+
+const ShaderInfo* ShaderRegistry::find(const std::string& name) {
+    for (size_t i = 0; i < EMBEDDED_SHADER_COUNT; i++) {
+        if (name == EMBEDDED_SHADERS[i].name) {
+            return &EMBEDDED_SHADERS[i];
+        }
+    }
+    LOGE("ShaderRegistry: Shader not embedded: %s", name.c_str());
+    return nullptr;
+}
+
+} // namespace framegen
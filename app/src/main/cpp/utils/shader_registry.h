@@ -0,0 +1,40 @@
+/**
+ * Shader Registry — SPIR-V embedded into the library at build time.
+ *
+ * CMake compiles every .comp under shaders/ with glslangValidator, optimizes
+ * it with spirv-opt when available, and runs tools/gen_shader_registry.py to
+ * emit the blobs plus their reflected interface. Descriptor layouts come
+ * from the SPIR-V itself, so they cannot drift from the shader source.
+ */
+
+#pragma once
+
+#include "../framegen_types.h"
+#include <string>
+
+namespace framegen {
+
+struct ShaderInfo {
+    const char* name;                           // Source file stem, e.g. "block_match_int8"
+    const uint32_t* code;
+    size_t codeSize;                            // Bytes
+    const VkDescriptorSetLayoutBinding* bindings;  // Descriptor set 0, sorted by binding
+    uint32_t bindingCount;
+    uint32_t pushConstantSize;                  // Bytes, 0 if none
+    uint32_t localSize[3];
+};
+
+// Generated table (shader_registry_data.cpp in the build directory)
+extern const ShaderInfo EMBEDDED_SHADERS[];
+extern const size_t EMBEDDED_SHADER_COUNT;
+
+class ShaderRegistry {
+public:
+    /**
+     * Look up an embedded shader by source name.
+     * @return nullptr if the shader was not built into this library
+     */
+    static const ShaderInfo* find(const std::string& name);
+};
+
+} // namespace framegen
@@ -3,7 +3,9 @@
  */
 
 #include "vulkan_capture.h"
+#include "../pipeline/frame_table.h"
 #include <algorithm>
+#include <cinttypes>
 
 namespace framegen {
 
@@ -13,12 +15,13 @@ VulkanCapture::~VulkanCapture() {
 
 bool VulkanCapture::init(VkDevice device, VkPhysicalDevice physicalDevice,
                          uint32_t queueFamilyIndex, uint32_t width,
-                         uint32_t height, VkFormat format) {
+                         uint32_t height, VkFormat format, uint32_t bufferCount) {
     device_ = device;
     physicalDevice_ = physicalDevice;
     width_ = width;
     height_ = height;
     format_ = format;
+    bufferCount_ = bufferCount;
 
     // Create command pool
     VkCommandPoolCreateInfo poolInfo{};
@@ -74,6 +77,7 @@ bool VulkanCapture::createBuffer(CaptureBuffer& buf) {
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT |   // CPU backend readback
                       VK_IMAGE_USAGE_SAMPLED_BIT |
                       VK_IMAGE_USAGE_STORAGE_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -156,6 +160,21 @@ FrameData VulkanCapture::captureFrame(VkQueue queue, VkImage swapchainImage,
                                        uint64_t frameIndex) {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    // Never overwrite an image the pipeline still reads; take the next
+    // free one, or drop this frame if the whole ring is held
+    if (frameTable_) {
+        uint32_t tried = 0;
+        while (tried < bufferCount_ && frameTable_->references(buffers_[currentIndex_].image)) {
+            currentIndex_ = (currentIndex_ + 1) % bufferCount_;
+            tried++;
+        }
+        if (tried == bufferCount_) {
+            LOGW("VulkanCapture: All %u ring images in use, skipping frame %" PRIu64,
+                 bufferCount_, frameIndex);
+            return FrameData{};
+        }
+    }
+
     CaptureBuffer& buf = buffers_[currentIndex_];
 
     // Wait for previous use of this buffer to complete
@@ -239,6 +258,8 @@ FrameData VulkanCapture::captureFrame(VkQueue queue, VkImage swapchainImage,
     frame.is_interpolated = false;
 
     // Advance ring buffer
+    lastIndices_[0] = lastIndices_[1];
+    lastIndices_[1] = currentIndex_;
     currentIndex_ = (currentIndex_ + 1) % bufferCount_;
 
     return frame;
@@ -247,8 +268,9 @@ FrameData VulkanCapture::captureFrame(VkQueue queue, VkImage swapchainImage,
 std::pair<FrameData, FrameData> VulkanCapture::getLastTwoFrames() const {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    uint32_t prev = (currentIndex_ + bufferCount_ - 2) % bufferCount_;
-    uint32_t curr = (currentIndex_ + bufferCount_ - 1) % bufferCount_;
+    // Skipped ring images make the last two non-adjacent
+    uint32_t prev = lastIndices_[0];
+    uint32_t curr = lastIndices_[1];
 
     auto makeFrame = [&](const CaptureBuffer& buf) -> FrameData {
         FrameData f;
@@ -13,20 +13,27 @@
 
 namespace framegen {
 
+class FrameTable;
+
 class VulkanCapture {
 public:
     VulkanCapture() = default;
     ~VulkanCapture();
 
-    // Initialize with the Vulkan device context
+    // Initialize with the Vulkan device context and a ring of bufferCount
+    // images (enough for every frame the pipeline holds at once)
     bool init(VkDevice device, VkPhysicalDevice physicalDevice,
               uint32_t queueFamilyIndex, uint32_t width, uint32_t height,
-              VkFormat format);
+              VkFormat format, uint32_t bufferCount);
 
     void shutdown();
 
+    // Ring images a live frame of this table still uses are skipped
+    void setFrameTable(const FrameTable* table) { frameTable_ = table; }
+
     // Capture a swapchain image into our ring buffer
-    // Returns the FrameData for the captured frame
+    // Returns the FrameData for the captured frame (image null when every
+    // ring image is still in use and the frame was not captured)
     FrameData captureFrame(VkQueue queue, VkImage swapchainImage,
                            VkImageLayout currentLayout, uint64_t frameIndex);
 
@@ -42,7 +49,7 @@ private:
     VkCommandPool commandPool_ = VK_NULL_HANDLE;
     VkFormat format_ = VK_FORMAT_R8G8B8A8_UNORM;
     uint32_t width_ = 0, height_ = 0;
-    uint32_t bufferCount_ = 4;
+    uint32_t bufferCount_ = 0;
 
     // Ring buffer of GPU images
     struct CaptureBuffer {
@@ -59,7 +66,9 @@ private:
 
     std::vector<CaptureBuffer> buffers_;
     uint32_t currentIndex_ = 0;
+    uint32_t lastIndices_[2] = {0, 0};   // Previous and newest capture
     mutable std::mutex mutex_;
+    const FrameTable* frameTable_ = nullptr;
 
     // Helpers
     bool createBuffer(CaptureBuffer& buf);
@@ -3,6 +3,7 @@
  */
 
 #include "vulkan_compute.h"
+#include <algorithm>
 #include <fstream>
 
 namespace framegen {
@@ -12,28 +13,29 @@ VulkanCompute::~VulkanCompute() {
 }
 
 bool VulkanCompute::init(VkDevice device, VkPhysicalDevice physicalDevice,
-                          uint32_t computeQueueFamilyIndex) {
+                          uint32_t computeQueueFamilyIndex, VkQueue queue) {
     device_ = device;
     physicalDevice_ = physicalDevice;
+    computeQueueFamily_ = computeQueueFamilyIndex;
 
-    vkGetDeviceQueue(device_, computeQueueFamilyIndex, 0, &computeQueue_);
-
-    // Command pool
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    poolInfo.queueFamilyIndex = computeQueueFamilyIndex;
+    if (queue != VK_NULL_HANDLE) {
+        computeQueue_ = queue;
+    } else {
+        vkGetDeviceQueue(device_, computeQueueFamilyIndex, 0, &computeQueue_);
+    }
 
-    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool_) != VK_SUCCESS) {
-        LOGE("VulkanCompute: Failed to create command pool");
+    // Command pool of the initializing thread; others get theirs on first use
+    if (threadCommandPool() == VK_NULL_HANDLE) {
         return false;
     }
 
-    // Descriptor pool — large enough for all our compute work
+    // Shared descriptor pool — static sets (motion estimator, fallback) and
+    // those of warm-up and autotuning images. Caches keyed by capture ring
+    // or output pool images get their own pools (reserveDescriptorSets).
     VkDescriptorPoolSize poolSizes[] = {
         {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 64},
         {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 32},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64},
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16},
     };
 
@@ -57,10 +59,34 @@ bool VulkanCompute::init(VkDevice device, VkPhysicalDevice physicalDevice,
         vkCreateSemaphore(device_, &semInfo, nullptr, &sem);
     }
 
+    queryCapabilities();
+
     LOGI("VulkanCompute: Initialized compute pipeline");
     return true;
 }
 
+void VulkanCompute::queryCapabilities() {
+    VkPhysicalDeviceSubgroupProperties subgroupProps{};
+    subgroupProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props2.pNext = &subgroupProps;
+    vkGetPhysicalDeviceProperties2(physicalDevice_, &props2);
+
+    const VkSubgroupFeatureFlags required = VK_SUBGROUP_FEATURE_BASIC_BIT |
+                                            VK_SUBGROUP_FEATURE_ARITHMETIC_BIT |
+                                            VK_SUBGROUP_FEATURE_CLUSTERED_BIT;
+
+    caps_.subgroupSize = subgroupProps.subgroupSize;
+    caps_.subgroupClustered =
+        (subgroupProps.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+        (subgroupProps.supportedOperations & required) == required;
+
+    LOGI("VulkanCompute: Subgroup size %u, clustered arithmetic %s",
+         caps_.subgroupSize, caps_.subgroupClustered ? "yes" : "no");
+}
+
 void VulkanCompute::shutdown() {
     if (device_ == VK_NULL_HANDLE) return;
 
@@ -75,8 +101,11 @@ void VulkanCompute::shutdown() {
             vkDestroyDescriptorSetLayout(device_, pipeline.descriptorSetLayout, nullptr);
         if (pipeline.shaderModule != VK_NULL_HANDLE)
             vkDestroyShaderModule(device_, pipeline.shaderModule, nullptr);
+        if (pipeline.descriptorPool != VK_NULL_HANDLE)
+            vkDestroyDescriptorPool(device_, pipeline.descriptorPool, nullptr);
     }
     pipelines_.clear();
+    reservedSets_.clear();
 
     for (auto& sem : semaphorePool_) {
         if (sem != VK_NULL_HANDLE) vkDestroySemaphore(device_, sem, nullptr);
@@ -84,8 +113,10 @@ void VulkanCompute::shutdown() {
 
     if (descriptorPool_ != VK_NULL_HANDLE)
         vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
-    if (commandPool_ != VK_NULL_HANDLE)
-        vkDestroyCommandPool(device_, commandPool_, nullptr);
+    for (auto& [thread, pool] : commandPools_) {
+        vkDestroyCommandPool(device_, pool, nullptr);
+    }
+    commandPools_.clear();
 
     device_ = VK_NULL_HANDLE;
 }
@@ -120,6 +151,15 @@ bool VulkanCompute::loadShaderFromFile(const std::string& name, const std::strin
     return loadShader(name, code.data(), fileSize);
 }
 
+bool VulkanCompute::loadShader(const std::string& name, const ShaderInfo& info) {
+    if (!loadShader(name, info.code, info.codeSize)) return false;
+    pipelines_[name].reflection = &info;
+    LOGI("VulkanCompute: Loaded %s as %s (%u bindings, %u push bytes, local %ux%ux%u)",
+         info.name, name.c_str(), info.bindingCount, info.pushConstantSize,
+         info.localSize[0], info.localSize[1], info.localSize[2]);
+    return true;
+}
+
 bool VulkanCompute::createPipeline(const std::string& shaderName,
                                     const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
     auto it = pipelines_.find(shaderName);
@@ -128,31 +168,56 @@ bool VulkanCompute::createPipeline(const std::string& shaderName,
         return false;
     }
 
+    // Push constant range (16 floats = 64 bytes for params)
+    return buildPipeline(shaderName, it->second, bindings.data(),
+                         static_cast<uint32_t>(bindings.size()), 64);
+}
+
+bool VulkanCompute::createPipeline(const std::string& shaderName) {
+    auto it = pipelines_.find(shaderName);
+    if (it == pipelines_.end()) {
+        LOGE("VulkanCompute: Shader not loaded: %s", shaderName.c_str());
+        return false;
+    }
+
     PipelineData& pd = it->second;
+    if (pd.pipeline != VK_NULL_HANDLE) return true;
+    if (!pd.reflection) {
+        LOGE("VulkanCompute: No reflection data for %s — pass bindings explicitly",
+             shaderName.c_str());
+        return false;
+    }
+
+    return buildPipeline(shaderName, pd, pd.reflection->bindings,
+                         pd.reflection->bindingCount, pd.reflection->pushConstantSize);
+}
 
+bool VulkanCompute::buildPipeline(const std::string& shaderName, PipelineData& pd,
+                                  const VkDescriptorSetLayoutBinding* bindings,
+                                  uint32_t bindingCount, uint32_t pushConstantSize) {
     // Descriptor set layout
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    layoutInfo.bindingCount = bindingCount;
+    layoutInfo.pBindings = bindings;
 
     if (vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr, &pd.descriptorSetLayout) != VK_SUCCESS) {
         return false;
     }
+    pd.bindings.assign(bindings, bindings + bindingCount);  // Sizes reserved pools
 
-    // Push constant range (16 floats = 64 bytes for params)
     VkPushConstantRange pushRange{};
     pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
     pushRange.offset = 0;
-    pushRange.size = 64;
+    pushRange.size = pushConstantSize;
 
     // Pipeline layout
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = 1;
     pipelineLayoutInfo.pSetLayouts = &pd.descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    pipelineLayoutInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushRange : nullptr;
 
     if (vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr, &pd.pipelineLayout) != VK_SUCCESS) {
         return false;
@@ -176,10 +241,44 @@ bool VulkanCompute::createPipeline(const std::string& shaderName,
     return true;
 }
 
+VkCommandPool VulkanCompute::threadCommandPool() {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    auto it = commandPools_.find(std::this_thread::get_id());
+    if (it != commandPools_.end()) return it->second;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = computeQueueFamily_;
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        LOGE("VulkanCompute: Failed to create command pool");
+        return VK_NULL_HANDLE;
+    }
+    commandPools_[std::this_thread::get_id()] = pool;
+    return pool;
+}
+
+void VulkanCompute::releaseThreadCommandPool() {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    auto it = commandPools_.find(std::this_thread::get_id());
+    if (it == commandPools_.end()) return;
+
+    // endComputeAndSubmit() work is not fenced, so its command buffers may
+    // still be pending; only called when a thread exits, so idling is cheap
+    {
+        std::lock_guard<std::mutex> queueLock(queueMutex_);
+        vkQueueWaitIdle(computeQueue_);
+    }
+    vkDestroyCommandPool(device_, it->second, nullptr);
+    commandPools_.erase(it);
+}
+
 VkCommandBuffer VulkanCompute::beginCompute() {
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = commandPool_;
+    allocInfo.commandPool = threadCommandPool();
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     allocInfo.commandBufferCount = 1;
 
@@ -224,6 +323,7 @@ void VulkanCompute::dispatch(VkCommandBuffer cmd, const DispatchInfo& info) {
 VkSemaphore VulkanCompute::endComputeAndSubmit(VkCommandBuffer cmd, VkSemaphore waitSemaphore) {
     vkEndCommandBuffer(cmd);
 
+    std::lock_guard<std::mutex> lock(queueMutex_);
     VkSemaphore signalSem = getNextSemaphore();
 
     VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
@@ -246,21 +346,150 @@ VkSemaphore VulkanCompute::endComputeAndSubmit(VkCommandBuffer cmd, VkSemaphore
     return signalSem;
 }
 
+bool VulkanCompute::endComputeAndWait(VkCommandBuffer cmd, VkSemaphore waitSemaphore) {
+    Submission submission = endComputeAsync(cmd, waitSemaphore);
+    return waitSubmission(submission);
+}
+
+VulkanCompute::Submission VulkanCompute::endComputeAsync(VkCommandBuffer cmd,
+                                                         VkSemaphore waitSemaphore) {
+    vkEndCommandBuffer(cmd);
+
+    Submission submission;
+    submission.cmd = cmd;
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(device_, &fenceInfo, nullptr, &submission.fence) != VK_SUCCESS) {
+        LOGE("VulkanCompute: Failed to create fence");
+        submission.fence = VK_NULL_HANDLE;
+        return submission;
+    }
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+
+    if (waitSemaphore != VK_NULL_HANDLE) {
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &waitSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    if (vkQueueSubmit(computeQueue_, 1, &submitInfo, submission.fence) != VK_SUCCESS) {
+        LOGE("VulkanCompute: Submit failed");
+        vkDestroyFence(device_, submission.fence, nullptr);
+        submission.fence = VK_NULL_HANDLE;
+    }
+    return submission;
+}
+
+bool VulkanCompute::waitSubmission(Submission& submission) {
+    bool ok = submission.fence != VK_NULL_HANDLE &&
+              vkWaitForFences(device_, 1, &submission.fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS;
+
+    if (submission.fence != VK_NULL_HANDLE) {
+        vkDestroyFence(device_, submission.fence, nullptr);
+    }
+    if (submission.cmd != VK_NULL_HANDLE) {
+        // Same thread as beginCompute(), so the same pool
+        vkFreeCommandBuffers(device_, threadCommandPool(), 1, &submission.cmd);
+    }
+    submission = Submission{};
+    return ok;
+}
+
 VkDescriptorSet VulkanCompute::allocateDescriptorSet(const std::string& pipelineName) {
     auto it = pipelines_.find(pipelineName);
-    if (it == pipelines_.end()) return VK_NULL_HANDLE;
+    if (it == pipelines_.end() || it->second.descriptorSetLayout == VK_NULL_HANDLE) {
+        LOGE("VulkanCompute: No pipeline layout for descriptor set: %s", pipelineName.c_str());
+        return VK_NULL_HANDLE;
+    }
+
+    std::lock_guard<std::mutex> lock(descriptorMutex_);
+    VkDescriptorPool pool = it->second.descriptorPool != VK_NULL_HANDLE
+                            ? it->second.descriptorPool : descriptorPool_;
 
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = descriptorPool_;
+    allocInfo.descriptorPool = pool;
     allocInfo.descriptorSetCount = 1;
     allocInfo.pSetLayouts = &it->second.descriptorSetLayout;
 
-    VkDescriptorSet set;
-    vkAllocateDescriptorSets(device_, &allocInfo, &set);
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    VkResult result = vkAllocateDescriptorSets(device_, &allocInfo, &set);
+    if (result != VK_SUCCESS) {
+        LOGE("VulkanCompute: Descriptor set allocation failed for %s (%d)",
+             pipelineName.c_str(), result);
+        return VK_NULL_HANDLE;
+    }
+    if (pool != descriptorPool_) reservedSets_[set] = pool;
     return set;
 }
 
+void VulkanCompute::freeDescriptorSet(VkDescriptorSet set) {
+    if (set == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(descriptorMutex_);
+    VkDescriptorPool pool = descriptorPool_;
+    auto it = reservedSets_.find(set);
+    if (it != reservedSets_.end()) {
+        pool = it->second;
+        reservedSets_.erase(it);
+    }
+    vkFreeDescriptorSets(device_, pool, 1, &set);
+}
+
+bool VulkanCompute::reserveDescriptorSets(const std::string& pipelineName, uint32_t count) {
+    auto it = pipelines_.find(pipelineName);
+    if (it == pipelines_.end() || it->second.bindings.empty()) {
+        LOGE("VulkanCompute: No pipeline layout to reserve sets for: %s", pipelineName.c_str());
+        return false;
+    }
+    PipelineData& pd = it->second;
+
+    // One pool size per descriptor type the layout uses
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    for (const auto& binding : pd.bindings) {
+        auto size = std::find_if(poolSizes.begin(), poolSizes.end(),
+            [&](const VkDescriptorPoolSize& s) { return s.type == binding.descriptorType; });
+        if (size == poolSizes.end()) {
+            poolSizes.push_back({binding.descriptorType, 0});
+            size = poolSizes.end() - 1;
+        }
+        size->descriptorCount += binding.descriptorCount * std::max<uint32_t>(count, 1);
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.maxSets = std::max<uint32_t>(count, 1);
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(device_, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        LOGE("VulkanCompute: Failed to reserve %u descriptor sets for %s",
+             count, pipelineName.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(descriptorMutex_);
+    if (pd.descriptorPool != VK_NULL_HANDLE) {
+        for (auto set = reservedSets_.begin(); set != reservedSets_.end();) {
+            set = set->second == pd.descriptorPool ? reservedSets_.erase(set) : std::next(set);
+        }
+        vkDestroyDescriptorPool(device_, pd.descriptorPool, nullptr);
+    }
+    pd.descriptorPool = pool;
+    LOGI("VulkanCompute: Reserved %u descriptor sets for %s", count, pipelineName.c_str());
+    return true;
+}
+
 void VulkanCompute::updateDescriptorImage(VkDescriptorSet set, uint32_t binding,
                                            VkImageView imageView, VkSampler sampler,
                                            VkImageLayout layout) {
@@ -298,10 +527,11 @@ void VulkanCompute::updateDescriptorStorageImage(VkDescriptorSet set, uint32_t b
 }
 
 void VulkanCompute::updateDescriptorBuffer(VkDescriptorSet set, uint32_t binding,
-                                            VkBuffer buffer, VkDeviceSize size) {
+                                            VkBuffer buffer, VkDeviceSize size,
+                                            VkDeviceSize offset) {
     VkDescriptorBufferInfo bufInfo{};
     bufInfo.buffer = buffer;
-    bufInfo.offset = 0;
+    bufInfo.offset = offset;
     bufInfo.range = size;
 
     VkWriteDescriptorSet write{};
@@ -5,13 +5,21 @@
  * - Motion estimation (optical flow)
  * - Frame interpolation (warping)
  * - Post-processing (sharpening, color correction)
+ *
+ * Pipeline stages record from several threads: each thread records into
+ * command buffers from its own pool, and submission, the semaphore ring
+ * and descriptor set allocation are serialized internally. Pipelines
+ * must be created before other threads use them.
  */
 
 #pragma once
 
 #include "../framegen_types.h"
+#include "../utils/shader_registry.h"
 #include <vector>
 #include <string>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace framegen {
@@ -21,18 +29,27 @@ public:
     VulkanCompute() = default;
     ~VulkanCompute();
 
+    // queue: use this queue instead of queue 0 of the family (for a
+    // VkDevice shared with another owner, e.g. NCNN's queue pool)
     bool init(VkDevice device, VkPhysicalDevice physicalDevice,
-              uint32_t computeQueueFamilyIndex);
+              uint32_t computeQueueFamilyIndex, VkQueue queue = VK_NULL_HANDLE);
     void shutdown();
 
     // Load a SPIR-V compute shader
     bool loadShader(const std::string& name, const uint32_t* spirvCode, size_t codeSize);
     bool loadShaderFromFile(const std::string& name, const std::string& path);
 
+    // Load an embedded shader; its reflected layout is kept for createPipeline(name)
+    bool loadShader(const std::string& name, const ShaderInfo& info);
+
     // Create a compute pipeline for a specific shader
     bool createPipeline(const std::string& shaderName,
                         const std::vector<VkDescriptorSetLayoutBinding>& bindings);
 
+    // Create a pipeline from the shader's reflected bindings and push-constant
+    // size. No-op if the pipeline already exists.
+    bool createPipeline(const std::string& shaderName);
+
     // Dispatch compute work
     struct DispatchInfo {
         std::string pipelineName;
@@ -47,35 +64,98 @@ public:
     VkCommandBuffer beginCompute();
     void dispatch(VkCommandBuffer cmd, const DispatchInfo& info);
     VkSemaphore endComputeAndSubmit(VkCommandBuffer cmd, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
+    // Submit and block until the work completes (hand-off to another queue)
+    bool endComputeAndWait(VkCommandBuffer cmd, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
+
+    // Submit without blocking, so the work overlaps with CPU-side waits on
+    // another queue; waitSubmission() completes it and frees the command buffer
+    struct Submission {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+    };
+    Submission endComputeAsync(VkCommandBuffer cmd, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
+    bool waitSubmission(Submission& submission);
+
+    // Destroy the calling thread's command pool, on a recording thread's
+    // way out; it is created again if the thread records later
+    void releaseThreadCommandPool();
 
-    // Resource creation helpers
+    // Resource creation helpers. allocateDescriptorSet() returns
+    // VK_NULL_HANDLE when the pipeline is unknown or its pool is exhausted.
     VkDescriptorSet allocateDescriptorSet(const std::string& pipelineName);
+    void freeDescriptorSet(VkDescriptorSet set);
+
+    /**
+     * Give a pipeline its own descriptor pool of count sets, sized from its
+     * layout, for a cache whose bound the caller knows (sets keyed by ring
+     * or pool images). Sets of other pipelines come from the shared pool,
+     * which only holds static and short-lived sets. A new reservation
+     * replaces the previous one; free its sets first.
+     */
+    bool reserveDescriptorSets(const std::string& pipelineName, uint32_t count);
     void updateDescriptorImage(VkDescriptorSet set, uint32_t binding,
                                VkImageView imageView, VkSampler sampler,
                                VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     void updateDescriptorStorageImage(VkDescriptorSet set, uint32_t binding,
                                       VkImageView imageView);
     void updateDescriptorBuffer(VkDescriptorSet set, uint32_t binding,
-                                VkBuffer buffer, VkDeviceSize size);
+                                VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset = 0);
+
+    // Device capabilities used to pick shader variants at load time
+    struct Capabilities {
+        uint32_t subgroupSize = 0;
+        bool subgroupClustered = false;  // basic + arithmetic + clustered ops in compute
+        bool shaderFloat16 = false;      // enabled on the VkDevice by its creator
+        bool shaderInt8 = false;
+    };
+    const Capabilities& getCapabilities() const { return caps_; }
+
+    // Record which VkPhysicalDeviceShaderFloat16Int8Features were enabled
+    void enableArithmeticTypes(bool float16, bool int8) {
+        caps_.shaderFloat16 = float16;
+        caps_.shaderInt8 = int8;
+    }
 
     VkDevice getDevice() const { return device_; }
     VkPhysicalDevice getPhysicalDevice() const { return physicalDevice_; }
     VkQueue getComputeQueue() const { return computeQueue_; }
+    uint32_t getComputeQueueFamily() const { return computeQueueFamily_; }
 
 private:
     VkDevice device_ = VK_NULL_HANDLE;
     VkPhysicalDevice physicalDevice_ = VK_NULL_HANDLE;
     VkQueue computeQueue_ = VK_NULL_HANDLE;
-    VkCommandPool commandPool_ = VK_NULL_HANDLE;
+    uint32_t computeQueueFamily_ = 0;
     VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
 
+    // Command pools are externally synchronized: one per recording thread
+    std::unordered_map<std::thread::id, VkCommandPool> commandPools_;
+    std::mutex poolMutex_;
+    VkCommandPool threadCommandPool();
+
+    std::mutex queueMutex_;         // vkQueueSubmit and the semaphore ring
+    std::mutex descriptorMutex_;    // descriptorPool_, reserved pools and reservedSets_
+
+    // Sets allocated from a pipeline's reserved pool, for freeDescriptorSet()
+    std::unordered_map<VkDescriptorSet, VkDescriptorPool> reservedSets_;
+
     struct PipelineData {
         VkShaderModule shaderModule = VK_NULL_HANDLE;
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
         VkPipeline pipeline = VK_NULL_HANDLE;
         VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        const ShaderInfo* reflection = nullptr;  // Set for embedded shaders
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;  // reserveDescriptorSets()
     };
 
+    bool buildPipeline(const std::string& shaderName, PipelineData& pd,
+                       const VkDescriptorSetLayoutBinding* bindings, uint32_t bindingCount,
+                       uint32_t pushConstantSize);
+
+    Capabilities caps_;
+    void queryCapabilities();
+
     std::unordered_map<std::string, PipelineData> pipelines_;
     std::vector<VkSemaphore> semaphorePool_;
     uint32_t semaphoreIndex_ = 0;
@@ -74,6 +74,10 @@ class FrameGenEngine {
         nativeSetMode(mode)
     }
 
+    fun setExtrapolation(enabled: Boolean) {
+        nativeSetExtrapolation(enabled)
+    }
+
     fun setQuality(quality: Float) {
         nativeSetQuality(quality.coerceIn(0f, 1f))
     }
@@ -112,6 +116,7 @@ class FrameGenEngine {
     private external fun nativeStop()
     private external fun nativeDestroy()
     private external fun nativeSetMode(mode: Int)
+    private external fun nativeSetExtrapolation(enabled: Boolean)
     private external fun nativeSetQuality(quality: Float)
     private external fun nativeGetStats(): FloatArray?
     private external fun nativeGetGpuTemp(): Float
@@ -0,0 +1,401 @@
+/**
+ * Block match fetch test — texture fetches of block_match.comp's tiled
+ * shared-memory kernel against the per-candidate sampling kernel it
+ * replaced, counted on CPU ports of both.
+ *
+ * Both ports run a three-level pyramid of a textured frame pair with a
+ * known motion, coarsest level first, each level seeded with the flow
+ * of the one below as MotionEstimator does. Every texture()/texelFetch()
+ * an invocation issues is counted, flow lookups included. Both must find
+ * the motion, and the tiled kernel must fetch at least FETCH_REDUCTION
+ * times less.
+ *
+ * The old kernel moved its diamond centre as soon as a point improved
+ * and stopped at the first round without one; the tiled kernel scores
+ * a round's 8 points from one centre. So the flows differ slightly, and
+ * the old kernel's early stop keeps its average well under the 29 SADs
+ * per block the shader header's worst case assumes.
+ *
+ * Sampling is at texel centres with clamp-to-edge; the coarse flow is
+ * read nearest, the same in both ports.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("FAIL %s:%d: %s — ", __FILE__, __LINE__, #cond);    \
+            std::printf(__VA_ARGS__);                                       \
+            std::printf("\n");                                              \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+constexpr int BASE_WIDTH = 320;
+constexpr int BASE_HEIGHT = 192;
+constexpr int LEVELS = 3;
+constexpr int SEARCH_RADIUS = 16;
+constexpr float MOTION_X = 9.3f;      // Full-resolution pixels
+constexpr float MOTION_Y = -5.6f;
+constexpr double FETCH_REDUCTION = 4.0;
+
+// Shader constants (block_match.comp)
+constexpr int BLOCK_SIZE = 8;
+constexpr int BLOCKS_X = 4;
+constexpr int BLOCKS_Y = 2;
+constexpr int GROUP_W = BLOCK_SIZE * BLOCKS_X;
+constexpr int GROUP_H = BLOCK_SIZE * BLOCKS_Y;
+constexpr int GROUP_INVOCATIONS = BLOCK_SIZE * BLOCKS_X * BLOCKS_Y;
+constexpr int MAX_SEARCH = 16;
+constexpr int APRON = 15;
+constexpr int TILE_W = GROUP_W + 2 * APRON;
+constexpr int TILE_H = GROUP_H + 2 * APRON;
+constexpr int DIAMOND_POINTS = 9;
+constexpr int MAX_CANDIDATES = DIAMOND_POINTS - 1;
+constexpr float INVALID_SAD = 1e10f;
+constexpr int DIAMOND[DIAMOND_POINTS][2] = {
+    {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
+};
+
+// A pyramid level's luma, sampled with a fetch counter
+struct Level {
+    int width = 0, height = 0;
+    std::vector<float> luma;
+
+    float fetch(int x, int y, uint64_t& fetches) const {
+        fetches++;
+        x = std::clamp(x, 0, width - 1);
+        y = std::clamp(y, 0, height - 1);
+        return luma[y * width + x];
+    }
+};
+
+struct Flow {
+    int width = 0, height = 0;
+    std::vector<std::array<float, 2>> vectors;
+
+    // Nearest sample at a pixel-space position
+    std::array<float, 2> sample(float px, float py, uint64_t& fetches) const {
+        fetches++;
+        int x = std::clamp(static_cast<int>(px), 0, width - 1);
+        int y = std::clamp(static_cast<int>(py), 0, height - 1);
+        return vectors[y * width + x];
+    }
+};
+
+// Two octaves of value noise (no period for the search to alias onto),
+// moved by (dx, dy)
+Level texturedLevel(int width, int height, float dx, float dy) {
+    auto lattice = [](int x, int y) {
+        uint32_t h = static_cast<uint32_t>(x) * 374761393u + static_cast<uint32_t>(y) * 668265263u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        return static_cast<float>((h ^ (h >> 16)) & 0xffff) / 65535.0f;
+    };
+    auto noise = [&](float x, float y, float cell) {
+        float gx = x / cell, gy = y / cell;
+        int x0 = static_cast<int>(std::floor(gx)), y0 = static_cast<int>(std::floor(gy));
+        float fx = gx - x0, fy = gy - y0;
+        fx = fx * fx * (3.0f - 2.0f * fx);
+        fy = fy * fy * (3.0f - 2.0f * fy);
+        float top = lattice(x0, y0) * (1 - fx) + lattice(x0 + 1, y0) * fx;
+        float bottom = lattice(x0, y0 + 1) * (1 - fx) + lattice(x0 + 1, y0 + 1) * fx;
+        return top * (1 - fy) + bottom * fy;
+    };
+    Level level{width, height, std::vector<float>(width * height)};
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float sx = x - dx, sy = y - dy;
+            level.luma[y * width + x] = 0.6f * noise(sx, sy, 24.0f) + 0.4f * noise(sx, sy, 6.0f);
+        }
+    }
+    return level;
+}
+
+// 2x2 box down to the next level
+Level downsample(const Level& source) {
+    Level out{source.width / 2, source.height / 2, {}};
+    out.luma.resize(out.width * out.height);
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            const float* row0 = &source.luma[(2 * y) * source.width + 2 * x];
+            const float* row1 = row0 + source.width;
+            out.luma[y * out.width + x] = (row0[0] + row0[1] + row1[0] + row1[1]) * 0.25f;
+        }
+    }
+    return out;
+}
+
+bool inBounds(const Level& level, int bx, int by, int ox, int oy) {
+    int tx = bx + ox, ty = by + oy;
+    return tx >= 0 && ty >= 0 && tx + BLOCK_SIZE <= level.width && ty + BLOCK_SIZE <= level.height;
+}
+
+// The parabola fit both kernels end with
+std::array<float, 2> subPixel(float bestSAD, float sadL, float sadR, float sadU, float sadD,
+                              const int best[2]) {
+    float subX = 0.0f, subY = 0.0f;
+    float dx = sadL + sadR - 2.0f * bestSAD;
+    float dy = sadU + sadD - 2.0f * bestSAD;
+    if (std::abs(dx) > 0.001f) subX = std::clamp((sadL - sadR) / (2.0f * dx), -0.5f, 0.5f);
+    if (std::abs(dy) > 0.001f) subY = std::clamp((sadU - sadD) / (2.0f * dy), -0.5f, 0.5f);
+    return {best[0] + subX, best[1] + subY};
+}
+
+void writeBlock(Flow& out, int bx, int by, const std::array<float, 2>& flow) {
+    for (int y = by; y < std::min(by + BLOCK_SIZE, out.height); y++) {
+        for (int x = bx; x < std::min(bx + BLOCK_SIZE, out.width); x++) {
+            out.vectors[y * out.width + x] = flow;
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// The kernel before tiling: one invocation per block, every candidate
+// sampled from both frames
+// ------------------------------------------------------------
+Flow perCandidateLevel(const Level& f1, const Level& f2, const Flow* coarse, uint64_t& fetches) {
+    Flow out{f1.width, f1.height, std::vector<std::array<float, 2>>(f1.width * f1.height)};
+
+    auto blockSAD = [&](int bx, int by, int ox, int oy) {
+        float sad = 0.0f;
+        for (int y = 0; y < BLOCK_SIZE; y++) {
+            for (int x = 0; x < BLOCK_SIZE; x++) {
+                sad += std::abs(f1.fetch(bx + x, by + y, fetches) -
+                                f2.fetch(bx + x + ox, by + y + oy, fetches));
+            }
+        }
+        return sad;
+    };
+
+    for (int by = 0; by < f1.height; by += BLOCK_SIZE) {
+        for (int bx = 0; bx < f1.width; bx += BLOCK_SIZE) {
+            std::array<float, 2> init{0.0f, 0.0f};
+            if (coarse) {
+                auto v = coarse->sample((bx + BLOCK_SIZE * 0.5f) / 2.0f, (by + BLOCK_SIZE * 0.5f) / 2.0f,
+                                        fetches);
+                init = {v[0] * 2.0f, v[1] * 2.0f};
+            }
+
+            int best[2] = {static_cast<int>(init[0]), static_cast<int>(init[1])};
+            float bestSAD = blockSAD(bx, by, best[0], best[1]);
+
+            for (int iter = 0; iter < 3; iter++) {
+                int stepSize = std::max(1, SEARCH_RADIUS >> (iter + 1));
+                bool improved = false;
+                for (int p = 1; p < DIAMOND_POINTS; p++) {
+                    int ox = best[0] + DIAMOND[p][0] * stepSize;
+                    int oy = best[1] + DIAMOND[p][1] * stepSize;
+                    if (!inBounds(f1, bx, by, ox, oy)) continue;
+                    float sad = blockSAD(bx, by, ox, oy);
+                    if (sad < bestSAD) {
+                        bestSAD = sad;
+                        best[0] = ox;
+                        best[1] = oy;
+                        improved = true;
+                    }
+                }
+                if (!improved) break;
+            }
+
+            float sadL = blockSAD(bx, by, best[0] - 1, best[1]);
+            float sadR = blockSAD(bx, by, best[0] + 1, best[1]);
+            float sadU = blockSAD(bx, by, best[0], best[1] - 1);
+            float sadD = blockSAD(bx, by, best[0], best[1] + 1);
+
+            writeBlock(out, bx, by, subPixel(bestSAD, sadL, sadR, sadU, sadD, best));
+        }
+    }
+    return out;
+}
+
+// ------------------------------------------------------------
+// The tiled kernel: one workgroup per 4x2 blocks, frame2 luma and its
+// apron loaded into shared memory once, frame1 rows in registers
+// ------------------------------------------------------------
+Flow tiledLevel(const Level& f1, const Level& f2, const Flow* coarse, uint64_t& fetches) {
+    Flow out{f1.width, f1.height, std::vector<std::array<float, 2>>(f1.width * f1.height)};
+    float tileLuma[TILE_H][TILE_W];
+
+    int groupsX = (f1.width + GROUP_W - 1) / GROUP_W;
+    int groupsY = (f1.height + GROUP_H - 1) / GROUP_H;
+
+    for (int gy = 0; gy < groupsY; gy++) {
+        for (int gx = 0; gx < groupsX; gx++) {
+            int groupPos[2] = {gx * GROUP_W, gy * GROUP_H};
+
+            // Every invocation reads the group's coarse flow
+            int tileShift[2] = {0, 0};
+            if (coarse) {
+                std::array<float, 2> v{};
+                for (int i = 0; i < GROUP_INVOCATIONS; i++) {
+                    v = coarse->sample((groupPos[0] + GROUP_W * 0.5f) / 2.0f,
+                                       (groupPos[1] + GROUP_H * 0.5f) / 2.0f, fetches);
+                }
+                tileShift[0] = static_cast<int>(std::round(v[0] * 2.0f));
+                tileShift[1] = static_cast<int>(std::round(v[1] * 2.0f));
+            }
+            int tileOrigin[2] = {groupPos[0] + tileShift[0] - APRON, groupPos[1] + tileShift[1] - APRON};
+
+            for (int i = 0; i < TILE_W * TILE_H; i++) {
+                int tx = i % TILE_W, ty = i / TILE_W;
+                tileLuma[ty][tx] = f2.fetch(tileOrigin[0] + tx, tileOrigin[1] + ty, fetches);
+            }
+
+            auto frame2Luma = [&](int x, int y) {
+                int tx = x - tileOrigin[0], ty = y - tileOrigin[1];
+                if (tx >= 0 && ty >= 0 && tx < TILE_W && ty < TILE_H) return tileLuma[ty][tx];
+                return f2.fetch(x, y, fetches);
+            };
+
+            for (int slot = 0; slot < BLOCKS_X * BLOCKS_Y; slot++) {
+                int bx = groupPos[0] + (slot % BLOCKS_X) * BLOCK_SIZE;
+                int by = groupPos[1] + (slot / BLOCKS_X) * BLOCK_SIZE;
+                bool active = bx < f1.width && by < f1.height;
+
+                // Each of the block's row invocations keeps its frame1 row
+                float refRows[BLOCK_SIZE][BLOCK_SIZE];
+                for (int row = 0; row < BLOCK_SIZE; row++) {
+                    for (int x = 0; x < BLOCK_SIZE; x++) {
+                        refRows[row][x] = f1.fetch(bx + x, by + row, fetches);
+                    }
+                }
+
+                std::array<float, 2> init{0.0f, 0.0f};
+                if (coarse) {
+                    for (int row = 0; row < BLOCK_SIZE; row++) {
+                        auto v = coarse->sample((bx + BLOCK_SIZE * 0.5f) / 2.0f,
+                                                (by + BLOCK_SIZE * 0.5f) / 2.0f, fetches);
+                        init = {v[0] * 2.0f, v[1] * 2.0f};
+                    }
+                }
+
+                // Row SADs from the tile, summed over the block
+                auto evaluate = [&](const int cands[][2], const bool* valid, float* sads, int count) {
+                    for (int c = 0; c < count; c++) {
+                        if (!valid[c]) {
+                            sads[c] = INVALID_SAD;
+                            continue;
+                        }
+                        float sad = 0.0f;
+                        for (int row = 0; row < BLOCK_SIZE; row++) {
+                            for (int x = 0; x < BLOCK_SIZE; x++) {
+                                sad += std::abs(refRows[row][x] -
+                                                frame2Luma(bx + x + cands[c][0], by + row + cands[c][1]));
+                            }
+                        }
+                        sads[c] = sad;
+                    }
+                };
+
+                int best[2] = {static_cast<int>(init[0]), static_cast<int>(init[1])};
+                int cands[MAX_CANDIDATES][2];
+                bool valid[MAX_CANDIDATES];
+                float sads[MAX_CANDIDATES];
+
+                cands[0][0] = best[0];
+                cands[0][1] = best[1];
+                valid[0] = active;
+                evaluate(cands, valid, sads, 1);
+                float bestSAD = sads[0];
+
+                bool searching = active;
+                int radius = std::min(SEARCH_RADIUS, MAX_SEARCH);
+                for (int iter = 0; iter < 3; iter++) {
+                    int stepSize = std::max(1, radius >> (iter + 1));
+                    for (int p = 1; p < DIAMOND_POINTS; p++) {
+                        cands[p - 1][0] = best[0] + DIAMOND[p][0] * stepSize;
+                        cands[p - 1][1] = best[1] + DIAMOND[p][1] * stepSize;
+                        valid[p - 1] = searching && inBounds(f1, bx, by, cands[p - 1][0], cands[p - 1][1]);
+                    }
+                    evaluate(cands, valid, sads, MAX_CANDIDATES);
+
+                    bool improved = false;
+                    for (int c = 0; c < MAX_CANDIDATES; c++) {
+                        if (sads[c] < bestSAD) {
+                            bestSAD = sads[c];
+                            best[0] = cands[c][0];
+                            best[1] = cands[c][1];
+                            improved = true;
+                        }
+                    }
+                    searching = searching && improved;
+                }
+
+                const int probes[4][2] = {{best[0] - 1, best[1]}, {best[0] + 1, best[1]},
+                                          {best[0], best[1] - 1}, {best[0], best[1] + 1}};
+                const bool probeValid[4] = {active, active, active, active};
+                float probeSads[4];
+                evaluate(probes, probeValid, probeSads, 4);
+                if (!active) continue;
+
+                writeBlock(out, bx, by, subPixel(bestSAD, probeSads[0], probeSads[1],
+                                                 probeSads[2], probeSads[3], best));
+            }
+        }
+    }
+    return out;
+}
+
+template<typename Kernel>
+Flow runPyramid(const Level* f1, const Level* f2, Kernel kernel, uint64_t* fetches) {
+    Flow flow;
+    for (int level = LEVELS - 1; level >= 0; level--) {
+        fetches[level] = 0;
+        flow = kernel(f1[level], f2[level], level == LEVELS - 1 ? nullptr : &flow, fetches[level]);
+    }
+    return flow;
+}
+
+} // namespace
+
+int main() {
+    Level frame1[LEVELS], frame2[LEVELS];
+    frame1[0] = texturedLevel(BASE_WIDTH, BASE_HEIGHT, 0.0f, 0.0f);
+    frame2[0] = texturedLevel(BASE_WIDTH, BASE_HEIGHT, MOTION_X, MOTION_Y);
+    for (int level = 1; level < LEVELS; level++) {
+        frame1[level] = downsample(frame1[level - 1]);
+        frame2[level] = downsample(frame2[level - 1]);
+    }
+
+    uint64_t before[LEVELS], after[LEVELS];
+    Flow perCandidate = runPyramid(frame1, frame2, perCandidateLevel, before);
+    Flow tiled = runPyramid(frame1, frame2, tiledLevel, after);
+
+    std::printf("%-6s %10s %14s %10s %8s\n", "level", "size", "per-candidate", "tiled", "ratio");
+    uint64_t totalBefore = 0, totalAfter = 0;
+    for (int level = LEVELS - 1; level >= 0; level--) {
+        std::printf("%-6d %4dx%-5d %14llu %10llu %7.1fx\n", level, frame1[level].width,
+                    frame1[level].height, static_cast<unsigned long long>(before[level]),
+                    static_cast<unsigned long long>(after[level]),
+                    static_cast<double>(before[level]) / after[level]);
+        totalBefore += before[level];
+        totalAfter += after[level];
+    }
+    double ratio = static_cast<double>(totalBefore) / totalAfter;
+    std::printf("%-17s %14llu %10llu %7.1fx\n", "total", static_cast<unsigned long long>(totalBefore),
+                static_cast<unsigned long long>(totalAfter), ratio);
+
+    // Counting fetches of a search that lost the motion would prove nothing
+    for (const Flow* flow : {&perCandidate, &tiled}) {
+        const auto& centre = flow->vectors[(BASE_HEIGHT / 2) * BASE_WIDTH + BASE_WIDTH / 2];
+        CHECK(std::abs(centre[0] - MOTION_X) < 2.0f && std::abs(centre[1] - MOTION_Y) < 2.0f,
+              "%s flow at the centre (%.2f, %.2f), motion (%.2f, %.2f)",
+              flow == &tiled ? "tiled" : "per-candidate", centre[0], centre[1], MOTION_X, MOTION_Y);
+    }
+
+    CHECK(ratio >= FETCH_REDUCTION, "tiled kernel fetches %.1fx less, expected %.1fx",
+          ratio, FETCH_REDUCTION);
+
+    std::printf("%s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
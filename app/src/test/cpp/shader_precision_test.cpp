@@ -0,0 +1,443 @@
+/**
+ * Shader precision test — CPU ports of the FP32 compute shaders and their
+ * reduced-precision variants, run on the same fixed inputs, against the
+ * error bounds the variants' headers state:
+ *
+ * - rgb_to_gray_fp16.comp: within two r16f steps of the FP32 shader
+ * - frame_blend_fp16.comp: at most one 8-bit step from the FP32 shader
+ * - frame_warp_fp16.comp: sample positions within |flow| / 1024 px
+ * - block_match_int8.comp: every block SAD within 64/255 of the FP32
+ *   shader's. The searches may still part ways on near-equal candidates;
+ *   on these textured frames 95% of blocks must settle on the same offset
+ *
+ * The ports follow the GLSL line by line. float16_t arithmetic is
+ * emulated by rounding every intermediate to the nearest half (as a
+ * correctly rounded FP16 ALU does); sampling is at texel centres, so the
+ * texture unit's filtering drops out.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("FAIL %s:%d: %s — ", __FILE__, __LINE__, #cond);    \
+            std::printf(__VA_ARGS__);                                       \
+            std::printf("\n");                                              \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+constexpr int WIDTH = 128;
+constexpr int HEIGHT = 96;
+
+// Round to the nearest IEEE half (ties to even), kept in a float
+float h(float x) {
+    if (x == 0.0f || !std::isfinite(x)) return x;
+    int exponent;
+    std::frexp(x, &exponent);                           // x = m * 2^exponent, m in [0.5, 1)
+    float quantum = std::ldexp(1.0f, std::max(exponent, -13) - 11);  // 11 bits; subnormals below 2^-14
+    float rounded = std::nearbyint(x / quantum) * quantum;
+    return std::abs(rounded) > 65504.0f ? std::copysign(INFINITY, x) : rounded;
+}
+
+// A half's spacing at x: one r16f step
+float halfStep(float x) {
+    int exponent;
+    std::frexp(std::max(std::abs(x), 0x1p-14f), &exponent);
+    return std::ldexp(1.0f, exponent - 11);
+}
+
+// rgba8 unorm store
+int unorm8(float x) {
+    return static_cast<int>(std::nearbyint(std::clamp(x, 0.0f, 1.0f) * 255.0f));
+}
+
+// Seeded, so every run checks the same inputs
+struct Lcg {
+    uint32_t state;
+    uint32_t next() { return state = state * 1664525u + 1013904223u; }
+    float uniform() { return static_cast<float>(next() >> 8) / 16777216.0f; }
+};
+
+struct Rgba8 {
+    std::array<uint8_t, 4> c;
+    float channel(int i) const { return c[i] / 255.0f; }
+};
+
+struct Image {
+    int width = WIDTH, height = HEIGHT;
+    std::vector<Rgba8> texels = std::vector<Rgba8>(WIDTH * HEIGHT);
+
+    // texelFetch / texture at a texel centre, clamp to edge
+    const Rgba8& at(int x, int y) const {
+        x = std::clamp(x, 0, width - 1);
+        y = std::clamp(y, 0, height - 1);
+        return texels[y * width + x];
+    }
+};
+
+// Smooth gradients plus noise, in the range captured game frames span
+Image texturedImage(Lcg& rng, float phase) {
+    Image image;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            Rgba8& t = image.texels[y * WIDTH + x];
+            for (int i = 0; i < 3; i++) {
+                float v = 0.5f + 0.3f * std::sin(x * 0.21f + i + phase) * std::cos(y * 0.17f - phase) +
+                          0.15f * (rng.uniform() - 0.5f);
+                t.c[i] = static_cast<uint8_t>(unorm8(v));
+            }
+            t.c[3] = 255;
+        }
+    }
+    return image;
+}
+
+// ------------------------------------------------------------
+// rgb_to_gray
+// ------------------------------------------------------------
+void checkRgbToGray() {
+    int worstSteps = 0;
+    // Every 8-bit grey and a spread of colours
+    for (uint32_t i = 0; i < (1u << 24); i += 97) {
+        Rgba8 t{{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8),
+                 static_cast<uint8_t>(i >> 16), 255}};
+        float r = t.channel(0), g = t.channel(1), b = t.channel(2);
+
+        float luma32 = h(r * 0.299f + g * 0.587f + b * 0.114f);    // r16f store
+
+        float luma16 = h(h(h(h(r) * h(0.299f)) + h(h(g) * h(0.587f))) + h(h(b) * h(0.114f)));
+
+        int steps = static_cast<int>(std::nearbyint(std::abs(luma16 - luma32) / halfStep(luma32)));
+        worstSteps = std::max(worstSteps, steps);
+    }
+    std::printf("%-12s worst %d r16f steps\n", "rgb_to_gray", worstSteps);
+    CHECK(worstSteps <= 2, "FP16 luma %d r16f steps from FP32", worstSteps);
+}
+
+// ------------------------------------------------------------
+// frame_blend
+// ------------------------------------------------------------
+struct BlendInputs {
+    Image warped1, warped2;
+};
+
+std::array<int, 4> blend32(const BlendInputs& in, int x, int y, float t) {
+    const Rgba8& a = in.warped1.at(x, y);
+    const Rgba8& b = in.warped2.at(x, y);
+    float c1[4], c2[4];
+    for (int i = 0; i < 4; i++) {
+        c1[i] = a.channel(i);
+        c2[i] = b.channel(i);
+    }
+
+    float d0 = c1[0] - c2[0], d1 = c1[1] - c2[1], d2 = c1[2] - c2[2];
+    float diff = std::sqrt(d0 * d0 + d1 * d1 + d2 * d2);
+    float threshold = 0.1f;
+    float occlusion = 0.0f;
+    if (diff > threshold) {
+        float s = std::clamp((diff - threshold) / (threshold * 3.0f - threshold), 0.0f, 1.0f);
+        occlusion = s * s * (3.0f - 2.0f * s);
+    }
+
+    std::array<int, 4> out{};
+    for (int i = 0; i < 3; i++) {
+        float result = occlusion > 0.5f ? (t < 0.5f ? c1[i] : c2[i])
+                                        : c1[i] * (1.0f - t) + c2[i] * t;
+        float blurred = (in.warped1.at(x + 1, y).channel(i) + in.warped1.at(x - 1, y).channel(i) +
+                         in.warped1.at(x, y + 1).channel(i) + in.warped1.at(x, y - 1).channel(i)) *
+                        0.25f;
+        result += (result - blurred) * 0.15f;
+        out[i] = unorm8(result);
+    }
+    out[3] = 255;
+    return out;
+}
+
+std::array<int, 4> blend16(const BlendInputs& in, int x, int y, float blendFactor) {
+    const Rgba8& a = in.warped1.at(x, y);
+    const Rgba8& b = in.warped2.at(x, y);
+    float c1[4], c2[4];
+    for (int i = 0; i < 4; i++) {
+        c1[i] = h(a.channel(i));
+        c2[i] = h(b.channel(i));
+    }
+
+    float d0 = h(c1[0] - c2[0]), d1 = h(c1[1] - c2[1]), d2 = h(c1[2] - c2[2]);
+    float diff = h(std::sqrt(h(h(h(d0 * d0) + h(d1 * d1)) + h(d2 * d2))));
+    float threshold = h(0.1f);
+    float occlusion = 0.0f;
+    if (diff > threshold) {
+        float edge1 = h(threshold * 3.0f);
+        float s = std::clamp(h(h(diff - threshold) / h(edge1 - threshold)), 0.0f, 1.0f);
+        occlusion = h(h(s * s) * h(3.0f - h(2.0f * s)));
+    }
+
+    float t = h(blendFactor);
+    std::array<int, 4> out{};
+    for (int i = 0; i < 3; i++) {
+        float result = occlusion > 0.5f ? (t < 0.5f ? c1[i] : c2[i])
+                                        : h(h(c1[i] * h(1.0f - t)) + h(c2[i] * t));
+        // The four taps are summed in FP32, then converted
+        float blurred = h(h(in.warped1.at(x + 1, y).channel(i) + in.warped1.at(x - 1, y).channel(i) +
+                            in.warped1.at(x, y + 1).channel(i) + in.warped1.at(x, y - 1).channel(i)) *
+                          0.25f);
+        result = h(result + h(h(result - blurred) * h(0.15f)));
+        out[i] = unorm8(result);
+    }
+    out[3] = 255;
+    return out;
+}
+
+void checkFrameBlend() {
+    // Warped frames that mostly agree (small noise), with patches where
+    // they do not (occlusions)
+    Lcg rng{7};
+    BlendInputs in{texturedImage(rng, 0.0f), {}};
+    in.warped2 = in.warped1;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            Rgba8& t = in.warped2.texels[y * WIDTH + x];
+            bool occluded = ((x / 16) + (y / 16)) % 5 == 0;
+            for (int i = 0; i < 3; i++) {
+                float noise = occluded ? rng.uniform() - 0.5f : 0.06f * (rng.uniform() - 0.5f);
+                t.c[i] = static_cast<uint8_t>(unorm8(t.channel(i) + noise));
+            }
+        }
+    }
+
+    int worstSteps = 0;
+    uint32_t compared = 0;
+    for (float t : {0.125f, 1.0f / 3.0f, 0.5f, 2.0f / 3.0f, 0.875f}) {
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < WIDTH; x++) {
+                auto full = blend32(in, x, y, t);
+                auto half = blend16(in, x, y, t);
+                for (int i = 0; i < 4; i++) {
+                    worstSteps = std::max(worstSteps, std::abs(full[i] - half[i]));
+                }
+                compared++;
+            }
+        }
+    }
+    std::printf("%-12s worst %d 8-bit steps over %u pixels\n", "frame_blend", worstSteps, compared);
+    CHECK(worstSteps <= 1, "FP16 blend %d 8-bit steps from FP32", worstSteps);
+}
+
+// ------------------------------------------------------------
+// frame_warp
+// ------------------------------------------------------------
+void checkFrameWarp() {
+    // Full-HD grid (the positions are where the precision matters), flow
+    // up to 64 px as RG16F stores it
+    constexpr int W = 1920, H = 1080;
+    constexpr float MAX_FLOW = 64.0f;
+    Lcg rng{11};
+
+    float worstRatio = 0.0f;    // Position error / (|flow| / 1024)
+    for (int sample = 0; sample < 200000; sample++) {
+        int x = static_cast<int>(rng.next() % W);
+        int y = static_cast<int>(rng.next() % H);
+        float flow[2] = {h((rng.uniform() * 2.0f - 1.0f) * MAX_FLOW),
+                         h((rng.uniform() * 2.0f - 1.0f) * MAX_FLOW)};
+        float timestep = rng.uniform();
+        float direction = (sample & 1) ? 1.0f : -1.0f;
+
+        float uv[2] = {(x + 0.5f) / W, (y + 0.5f) / H};
+        float size[2] = {static_cast<float>(W), static_cast<float>(H)};
+        float factor16 = h(direction * timestep);
+
+        float flowLength = std::hypot(flow[0], flow[1]);
+        float error = 0.0f;
+        for (int i = 0; i < 2; i++) {
+            float src32 = uv[i] - (flow[i] * direction * timestep) / size[i];
+            float src16 = uv[i] - h(flow[i] * factor16) / size[i];
+            error = std::max(error, std::abs(src32 - src16) * size[i]);
+        }
+        // Plus one FP32 UV rounding at this resolution
+        float bound = flowLength / 1024.0f + 2.0f * W * std::ldexp(1.0f, -24);
+        worstRatio = std::max(worstRatio, error / bound);
+    }
+    std::printf("%-12s worst %.2f of the |flow| / 1024 bound\n", "frame_warp", worstRatio);
+    CHECK(worstRatio <= 1.0f, "FP16 warp positions %.2fx the stated bound", worstRatio);
+}
+
+// ------------------------------------------------------------
+// block_match — one level, no coarser flow, search radius 16
+// ------------------------------------------------------------
+constexpr int BLOCK_SIZE = 8;
+constexpr int MAX_SEARCH = 16;
+constexpr int DIAMOND_POINTS = 9;
+constexpr float INVALID_SAD = 1e10f;
+constexpr int DIAMOND[DIAMOND_POINTS][2] = {
+    {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
+};
+
+float lumaFp32(const Image& image, int x, int y) {
+    const Rgba8& t = image.at(x, y);
+    return t.channel(0) * 0.299f + t.channel(1) * 0.587f + t.channel(2) * 0.114f;
+}
+
+uint8_t lumaInt8(const Image& image, int x, int y) {
+    return static_cast<uint8_t>(lumaFp32(image, x, y) * 255.0f + 0.5f);
+}
+
+struct Match {
+    int offset[2];
+    float flow[2];
+};
+
+bool inBounds(int bx, int by, int ox, int oy) {
+    int tx = bx + ox, ty = by + oy;
+    return tx >= 0 && ty >= 0 && tx + BLOCK_SIZE <= WIDTH && ty + BLOCK_SIZE <= HEIGHT;
+}
+
+float blockSadFp32(const Image& f1, const Image& f2, int bx, int by, int ox, int oy) {
+    float sad = 0.0f;
+    for (int y = 0; y < BLOCK_SIZE; y++) {
+        for (int x = 0; x < BLOCK_SIZE; x++) {
+            sad += std::abs(lumaFp32(f1, bx + x, by + y) - lumaFp32(f2, bx + x + ox, by + y + oy));
+        }
+    }
+    return sad;
+}
+
+// Integer abs-diff sums, rescaled to luma units as the INT8 shader does
+float blockSadInt8(const Image& f1, const Image& f2, int bx, int by, int ox, int oy) {
+    uint32_t sad = 0;
+    for (int y = 0; y < BLOCK_SIZE; y++) {
+        for (int x = 0; x < BLOCK_SIZE; x++) {
+            sad += static_cast<uint32_t>(std::abs(int(lumaInt8(f1, bx + x, by + y)) -
+                                                  int(lumaInt8(f2, bx + x + ox, by + y + oy))));
+        }
+    }
+    return static_cast<float>(sad) / 255.0f;
+}
+
+template<typename Sad>
+Match searchBlock(const Image& f1, const Image& f2, int bx, int by, Sad sad) {
+    int best[2] = {0, 0};
+    float bestSAD = sad(f1, f2, bx, by, 0, 0);
+
+    int radius = MAX_SEARCH;
+    bool searching = true;
+    for (int iter = 0; iter < 3 && searching; iter++) {
+        int stepSize = std::max(1, radius >> (iter + 1));
+        int centre[2] = {best[0], best[1]};
+        bool improved = false;
+        for (int p = 1; p < DIAMOND_POINTS; p++) {
+            int ox = centre[0] + DIAMOND[p][0] * stepSize;
+            int oy = centre[1] + DIAMOND[p][1] * stepSize;
+            float s = inBounds(bx, by, ox, oy) ? sad(f1, f2, bx, by, ox, oy) : INVALID_SAD;
+            if (s < bestSAD) {
+                bestSAD = s;
+                best[0] = ox;
+                best[1] = oy;
+                improved = true;
+            }
+        }
+        searching = improved;
+    }
+
+    float sadL = sad(f1, f2, bx, by, best[0] - 1, best[1]);
+    float sadR = sad(f1, f2, bx, by, best[0] + 1, best[1]);
+    float sadU = sad(f1, f2, bx, by, best[0], best[1] - 1);
+    float sadD = sad(f1, f2, bx, by, best[0], best[1] + 1);
+
+    float subX = 0.0f, subY = 0.0f;
+    float dx = sadL + sadR - 2.0f * bestSAD;
+    float dy = sadU + sadD - 2.0f * bestSAD;
+    if (std::abs(dx) > 0.001f) subX = std::clamp((sadL - sadR) / (2.0f * dx), -0.5f, 0.5f);
+    if (std::abs(dy) > 0.001f) subY = std::clamp((sadU - sadD) / (2.0f * dy), -0.5f, 0.5f);
+
+    return {{best[0], best[1]}, {best[0] + subX, best[1] + subY}};
+}
+
+// Frame 2 is frame 1 moved by (MOTION_X, MOTION_Y), bilinearly resampled
+constexpr float MOTION_X = 5.4f;
+constexpr float MOTION_Y = -3.3f;
+
+Image shifted(const Image& source) {
+    Image out;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float sx = x - MOTION_X, sy = y - MOTION_Y;
+            int x0 = static_cast<int>(std::floor(sx)), y0 = static_cast<int>(std::floor(sy));
+            float fx = sx - x0, fy = sy - y0;
+            Rgba8& t = out.texels[y * WIDTH + x];
+            for (int i = 0; i < 4; i++) {
+                float v = source.at(x0, y0).channel(i) * (1 - fx) * (1 - fy) +
+                          source.at(x0 + 1, y0).channel(i) * fx * (1 - fy) +
+                          source.at(x0, y0 + 1).channel(i) * (1 - fx) * fy +
+                          source.at(x0 + 1, y0 + 1).channel(i) * fx * fy;
+                t.c[i] = static_cast<uint8_t>(unorm8(v));
+            }
+        }
+    }
+    return out;
+}
+
+void checkBlockMatch() {
+    Lcg rng{23};
+    Image frame1 = texturedImage(rng, 0.7f);
+    Image frame2 = shifted(frame1);
+
+    // Each luma is off by at most half a step in each frame
+    constexpr float QUANTIZATION_BOUND = BLOCK_SIZE * BLOCK_SIZE / 255.0f;
+    constexpr float MIN_SAME_OFFSET = 0.95f;
+    float worstSad = 0.0f;
+    float worstSubPixel = 0.0f;
+    uint32_t blocks = 0, sameOffset = 0;
+
+    for (int by = 0; by + BLOCK_SIZE <= HEIGHT; by += BLOCK_SIZE) {
+        for (int bx = 0; bx + BLOCK_SIZE <= WIDTH; bx += BLOCK_SIZE) {
+            // Every candidate the search can reach
+            for (int oy = -MAX_SEARCH; oy <= MAX_SEARCH; oy++) {
+                for (int ox = -MAX_SEARCH; ox <= MAX_SEARCH; ox++) {
+                    if (!inBounds(bx, by, ox, oy)) continue;
+                    worstSad = std::max(worstSad,
+                                        std::abs(blockSadInt8(frame1, frame2, bx, by, ox, oy) -
+                                                 blockSadFp32(frame1, frame2, bx, by, ox, oy)));
+                }
+            }
+
+            Match full = searchBlock(frame1, frame2, bx, by, blockSadFp32);
+            Match quantized = searchBlock(frame1, frame2, bx, by, blockSadInt8);
+            if (full.offset[0] == quantized.offset[0] && full.offset[1] == quantized.offset[1]) {
+                sameOffset++;
+                worstSubPixel = std::max({worstSubPixel, std::abs(full.flow[0] - quantized.flow[0]),
+                                          std::abs(full.flow[1] - quantized.flow[1])});
+            }
+            blocks++;
+        }
+    }
+    float sameShare = static_cast<float>(sameOffset) / blocks;
+    std::printf("%-12s worst SAD delta %.3f (bound %.3f), %u/%u blocks same offset, "
+                "sub-pixel delta %.3f px\n",
+                "block_match", worstSad, QUANTIZATION_BOUND, sameOffset, blocks, worstSubPixel);
+    CHECK(worstSad <= QUANTIZATION_BOUND, "INT8 SAD %.3f from FP32's", worstSad);
+    CHECK(sameShare >= MIN_SAME_OFFSET, "%.1f%% of blocks settled on FP32's offset",
+          sameShare * 100.0f);
+}
+
+} // namespace
+
+int main() {
+    checkRgbToGray();
+    checkFrameBlend();
+    checkFrameWarp();
+    checkBlockMatch();
+
+    std::printf("%s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+/**
+ * Host stand-in for <android/log.h> — engine logging goes to stderr when
+ * FG_TEST_VERBOSE is set in the environment, nowhere otherwise.
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6,
+};
+
+inline int __android_log_print(int priority, const char* tag, const char* fmt, ...) {
+    static const bool verbose = std::getenv("FG_TEST_VERBOSE") != nullptr;
+    if (!verbose && priority < ANDROID_LOG_ERROR) return 0;
+
+    std::fprintf(stderr, "%s: ", tag);
+    va_list args;
+    va_start(args, fmt);
+    int n = std::vfprintf(stderr, fmt, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+    return n;
+}
@@ -0,0 +1,19 @@
+/**
+ * Host stand-in for <vulkan/vulkan.h> — only the handle and enum names
+ * framegen_types.h mentions, so CPU-only pipeline code builds off-device.
+ */
+
+#pragma once
+
+#define VK_NULL_HANDLE nullptr
+
+typedef struct VkImage_T* VkImage;
+typedef struct VkImageView_T* VkImageView;
+typedef struct VkDeviceMemory_T* VkDeviceMemory;
+typedef struct VkFramebuffer_T* VkFramebuffer;
+typedef struct VkSemaphore_T* VkSemaphore;
+typedef struct VkFence_T* VkFence;
+
+typedef enum VkFormat {
+    VK_FORMAT_R8G8B8A8_UNORM = 37,
+} VkFormat;
@@ -0,0 +1,164 @@
+/**
+ * Thread policy test — ThreadPolicy::discover() and cpusFor() against fake
+ * sysfs trees (cpuN/cpufreq/cpuinfo_max_freq) built in a temp directory.
+ *
+ * - tri-cluster: little/mid/big, listed out of order, with an offline
+ *   CPU (no cpufreq dir) and the non-CPU entries a real cpu dir has
+ * - big-first: the big cores numbered lowest; clusters still ascend
+ * - single cluster: every role unrestricted
+ * - no tree: no clusters, every role unrestricted
+ */
+
+#include "pipeline/thread_policy.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace framegen;
+namespace fs = std::filesystem;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("FAIL %s:%d: %s — ", __FILE__, __LINE__, #cond);    \
+            std::printf(__VA_ARGS__);                                       \
+            std::printf("\n");                                              \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+using Role = ThreadPolicy::Role;
+
+// A sysfs cpu dir under the system temp dir, removed with the object
+class FakeSysfs {
+public:
+    explicit FakeSysfs(const char* name)
+        : root_(fs::temp_directory_path() / (std::string("thread_policy_test_") + name)) {
+        fs::remove_all(root_);
+        fs::create_directories(root_);
+    }
+    ~FakeSysfs() { fs::remove_all(root_); }
+
+    void online(int cpu, uint32_t maxFreqKhz) {
+        fs::path dir = root_ / ("cpu" + std::to_string(cpu)) / "cpufreq";
+        fs::create_directories(dir);
+        std::ofstream(dir / "cpuinfo_max_freq") << maxFreqKhz << "\n";
+    }
+
+    // Hotplugged out: the cpu dir stays, its cpufreq goes
+    void offline(int cpu) { fs::create_directories(root_ / ("cpu" + std::to_string(cpu))); }
+
+    // What else lives in /sys/devices/system/cpu
+    void addNoise() {
+        fs::create_directories(root_ / "cpufreq" / "policy0");
+        fs::create_directories(root_ / "cpuidle");
+        std::ofstream(root_ / "possible") << "0-7\n";
+        std::ofstream(root_ / "online") << "0-7\n";
+    }
+
+    std::string path() const { return root_.string(); }
+
+private:
+    fs::path root_;
+};
+
+uint64_t cpus(std::initializer_list<int> list) {
+    uint64_t mask = 0;
+    for (int cpu : list) mask |= 1ULL << cpu;
+    return mask;
+}
+
+void checkClusters(const char* name, const ThreadPolicy& policy,
+                   const std::vector<std::pair<uint32_t, uint64_t>>& expected) {
+    const auto& clusters = policy.getClusters();
+    CHECK(clusters.size() == expected.size(), "%s: %zu clusters, expected %zu",
+          name, clusters.size(), expected.size());
+    for (size_t i = 0; i < std::min(clusters.size(), expected.size()); i++) {
+        CHECK(clusters[i].maxFreqKhz == expected[i].first && clusters[i].cpuMask == expected[i].second,
+              "%s: cluster %zu is %u kHz 0x%llx, expected %u kHz 0x%llx", name, i,
+              clusters[i].maxFreqKhz, static_cast<unsigned long long>(clusters[i].cpuMask),
+              expected[i].first, static_cast<unsigned long long>(expected[i].second));
+    }
+}
+
+void checkRole(const char* name, const ThreadPolicy& policy, Role role, uint64_t expected) {
+    uint64_t mask = policy.cpusFor(role);
+    CHECK(mask == expected, "%s: %s on 0x%llx, expected 0x%llx", name,
+          ThreadPolicy::roleName(role), static_cast<unsigned long long>(mask),
+          static_cast<unsigned long long>(expected));
+}
+
+void triCluster() {
+    FakeSysfs sysfs("tri");
+    sysfs.addNoise();
+    for (int cpu : {7, 3, 5, 0, 2, 4, 1, 6}) {
+        sysfs.online(cpu, cpu < 4 ? 1804800 : cpu < 7 ? 2419200 : 3187200);
+    }
+    sysfs.offline(8);
+
+    ThreadPolicy policy(sysfs.path());
+    CHECK(policy.discover() == 3, "tri-cluster: discover() found %zu", policy.getClusters().size());
+    checkClusters("tri-cluster", policy, {{1804800, cpus({0, 1, 2, 3})},
+                                          {2419200, cpus({4, 5, 6})},
+                                          {3187200, cpus({7})}});
+    checkRole("tri-cluster", policy, Role::PRESENT, cpus({7}));
+    checkRole("tri-cluster", policy, Role::WORKER, cpus({4, 5, 6, 7}));
+    checkRole("tri-cluster", policy, Role::TELEMETRY, cpus({0, 1, 2, 3}));
+}
+
+void bigFirst() {
+    FakeSysfs sysfs("big_first");
+    sysfs.online(0, 2841600);
+    sysfs.online(1, 2841600);
+    for (int cpu = 2; cpu < 6; cpu++) sysfs.online(cpu, 1785600);
+
+    ThreadPolicy policy(sysfs.path());
+    CHECK(policy.discover() == 2, "big-first: discover() found %zu", policy.getClusters().size());
+    checkClusters("big-first", policy, {{1785600, cpus({2, 3, 4, 5})},
+                                        {2841600, cpus({0, 1})}});
+    checkRole("big-first", policy, Role::PRESENT, cpus({0, 1}));
+    checkRole("big-first", policy, Role::WORKER, cpus({0, 1}));
+    checkRole("big-first", policy, Role::TELEMETRY, cpus({2, 3, 4, 5}));
+}
+
+void singleCluster() {
+    FakeSysfs sysfs("single");
+    for (int cpu = 0; cpu < 4; cpu++) sysfs.online(cpu, 2000000);
+    sysfs.offline(4);
+
+    ThreadPolicy policy(sysfs.path());
+    CHECK(policy.discover() == 1, "single: discover() found %zu", policy.getClusters().size());
+    checkClusters("single", policy, {{2000000, cpus({0, 1, 2, 3})}});
+    for (Role role : {Role::PRESENT, Role::WORKER, Role::TELEMETRY}) {
+        checkRole("single", policy, role, 0);
+    }
+}
+
+void noTree() {
+    ThreadPolicy policy((fs::temp_directory_path() / "thread_policy_test_missing").string());
+    CHECK(policy.discover() == 0, "missing: discover() found %zu", policy.getClusters().size());
+    for (Role role : {Role::PRESENT, Role::WORKER, Role::TELEMETRY}) {
+        checkRole("missing", policy, role, 0);
+    }
+}
+
+} // namespace
+
+int main() {
+    triCluster();
+    bigFirst();
+    singleCluster();
+    noTree();
+
+    std::printf("%s\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+/**
+ * Timing replay test — the cost-model controller (TimingController::
+ * onPairComplete) against the p95 step heuristic it replaced, on the same
+ * frame-time traces.
+ *
+ * A trace scripts a device's load over a run of pairs: steady, a step in
+ * GPU contention and back, a slow thermal-like ramp, sparse spikes. A
+ * seeded generator adds per-pair noise, so every run replays identical
+ * frame times. Stage times are a fixed cost per setting (shaped like the
+ * engine's at 1080p) times the load. Settings chosen after pair n apply
+ * from pair n + 1 + PIPELINE_LAG, since pairs already in flight finish at
+ * the old ones.
+ *
+ * Per trace and controller:
+ * - violations: pairs whose time per generated frame exceeds the budget
+ * - convergence: pairs after a load change until a full window stays
+ *   within VIOLATION_TOLERANCE (the worst over the trace's changes)
+ * - changes: rung or radius switches actually run, to catch oscillation
+ */
+
+#include "pipeline/timing_controller.h"
+#include "pipeline/rolling_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+using namespace framegen;
+
+namespace {
+
+constexpr uint32_t WIDTH = 1920;
+constexpr uint32_t HEIGHT = 1080;
+constexpr float BUDGET_MS = 1000.0f / 120.0f;      // Per generated frame at 120 Hz
+constexpr uint32_t PIPELINE_LAG = 2;               // Pairs in flight at the old settings
+constexpr uint32_t CONVERGENCE_WINDOW = 60;
+constexpr float VIOLATION_TOLERANCE = 0.05f;
+
+int failures = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("FAIL %s:%d: %s — ", __FILE__, __LINE__, #cond);    \
+            std::printf(__VA_ARGS__);                                       \
+            std::printf("\n");                                              \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+struct Settings {
+    float modelScale = 0.5f;
+    uint32_t searchRadius = 16;
+};
+
+// The rung RifeEngine::setModelScale() snaps a requested scale to
+float snapToLadder(float scale) {
+    float best = MODEL_SCALE_LADDER[0];
+    for (float rung : MODEL_SCALE_LADDER) {
+        if (std::abs(rung - scale) < std::abs(best - scale)) best = rung;
+    }
+    return best;
+}
+
+// Stage times at unit load (ms)
+float synthesizeMs(float modelScale, uint32_t frames) {
+    float modelMpx = WIDTH * HEIGHT / 1.0e6f * modelScale * modelScale;
+    return 0.6f + 0.4f * frames + modelMpx * (1.2f + 6.0f * frames);
+}
+
+float estimateMs(uint32_t searchRadius) {
+    float mpx = WIDTH * HEIGHT / 1.0e6f;
+    return 0.3f + 0.5f * mpx + 0.6f * mpx * searchRadius / 16.0f;
+}
+
+// xorshift32: the same noise on every run and platform
+class Noise {
+public:
+    explicit Noise(uint32_t seed) : state_(seed ? seed : 1) {}
+
+    float uniform() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return static_cast<float>(state_ >> 8) / static_cast<float>(1u << 24);
+    }
+
+    // About +-8%, roughly normal
+    float jitter() {
+        float sum = uniform() + uniform() + uniform() + uniform();
+        return 1.0f + 0.04f * (sum - 2.0f);
+    }
+
+private:
+    uint32_t state_;
+};
+
+struct Trace {
+    const char* name;
+    uint32_t pairs;
+    uint32_t frames;                    // Generated per pair
+    bool estimate;                      // Extrapolating: motion estimation runs too
+    std::vector<uint32_t> changes;      // Pairs where the load changes, 0 first
+    std::function<float(uint32_t pair, Noise& noise)> load;
+};
+
+std::vector<Trace> traces() {
+    return {
+        {"steady", 1200, 1, false, {0},
+         [](uint32_t, Noise&) { return 1.0f; }},
+
+        {"contention_step", 2400, 1, false, {0, 600, 1500},
+         [](uint32_t pair, Noise&) { return pair >= 600 && pair < 1500 ? 2.0f : 1.0f; }},
+
+        {"thermal_ramp", 2400, 1, false, {0},
+         [](uint32_t pair, Noise&) { return 1.0f + 0.8f * std::min(1.0f, pair / 1800.0f); }},
+
+        {"spikes", 2400, 1, false, {0},
+         [](uint32_t, Noise& noise) { return noise.uniform() < 0.02f ? 2.2f : 1.0f; }},
+
+        {"two_per_pair_step", 2400, 2, false, {0, 800},
+         [](uint32_t pair, Noise&) { return pair >= 800 ? 2.2f : 1.0f; }},
+
+        {"extrapolation_step", 2400, 1, true, {0, 800},
+         [](uint32_t pair, Noise&) { return pair >= 800 ? 1.3f : 1.0f; }},
+    };
+}
+
+struct PairResult {
+    Settings settings;
+    uint32_t frames;
+    float estimateMs;       // Negative when not estimating
+    float synthesizeMs;
+};
+
+class Controller {
+public:
+    virtual ~Controller() = default;
+    virtual const char* name() const = 0;
+    virtual Settings initial() const = 0;
+    virtual std::optional<Settings> onPair(const PairResult& pair) = 0;
+};
+
+// The engine's controller, fed per-stage pair times
+class CostModelController : public Controller {
+public:
+    CostModelController() {
+        config_.max_frame_time_ns = static_cast<uint64_t>(BUDGET_MS * 1.0e6f);
+        config_.thermal_protection = false;     // No thermal zones off-device
+        timing_.init(config_);
+    }
+
+    const char* name() const override { return "cost model"; }
+
+    Settings initial() const override {
+        return {timing_.getState().currentScale, timing_.getState().currentSearchRadius};
+    }
+
+    std::optional<Settings> onPair(const PairResult& pair) override {
+        TimingController::PairSample sample;
+        sample.inputs.modelScale = pair.settings.modelScale;
+        sample.inputs.searchRadius = pair.settings.searchRadius;
+        sample.inputs.width = WIDTH;
+        sample.inputs.height = HEIGHT;
+        sample.inputs.frames = pair.frames;
+        sample.estimateMs = pair.estimateMs;
+        sample.synthesizeMs = pair.synthesizeMs;
+
+        auto chosen = timing_.onPairComplete(sample);
+        if (!chosen) return std::nullopt;
+        return Settings{chosen->modelScale, chosen->searchRadius};
+    }
+
+private:
+    Config config_;
+    TimingController timing_;
+};
+
+// The removed TimingController::onFrameComplete(): per-frame times, p95
+// of a 60-frame window, 5 frames over to step the scale down by 0.1 and
+// 30 under with p95 below 70% of the budget to step it up by 0.05. It
+// never changed the search radius.
+class HeuristicController : public Controller {
+public:
+    const char* name() const override { return "heuristic"; }
+    Settings initial() const override { return {scale_, 16}; }
+
+    std::optional<Settings> onPair(const PairResult& pair) override {
+        float totalMs = pair.synthesizeMs + std::max(pair.estimateMs, 0.0f);
+        float frameMs = totalMs / pair.frames;
+
+        bool changed = false;
+        for (uint32_t i = 0; i < pair.frames; i++) changed |= onFrameComplete(frameMs);
+        if (!changed) return std::nullopt;
+        return Settings{scale_, 16};
+    }
+
+private:
+    static constexpr size_t HISTORY_SIZE = 60;
+    static constexpr size_t MIN_DECISION_SAMPLES = 16;
+
+    RollingStats<HISTORY_SIZE> history_;
+    float scale_ = 0.5f;
+    int over_ = 0;
+    int under_ = 0;
+
+    // True when the scale changed
+    bool onFrameComplete(float frameMs) {
+        history_.push(frameMs);
+        float p95 = history_.percentile(0.95f);
+        bool overBudget = history_.count() >= MIN_DECISION_SAMPLES ? p95 > BUDGET_MS
+                                                                   : frameMs > BUDGET_MS;
+        over_ = overBudget ? over_ + 1 : 0;
+        under_ = overBudget ? 0 : under_ + 1;
+
+        if (over_ >= 5) {
+            scale_ = std::max(0.25f, scale_ - 0.1f);
+        } else if (under_ >= 30 && history_.full() && p95 < BUDGET_MS * 0.7f) {
+            scale_ = std::min(0.75f, scale_ + 0.05f);
+        } else {
+            return false;
+        }
+        over_ = 0;
+        under_ = 0;
+        history_.reset();
+        return true;
+    }
+};
+
+struct ReplayResult {
+    float violationRate = 0.0f;
+    uint32_t convergencePairs = 0;      // Worst over the trace's load changes
+    float meanScale = 0.0f;             // Quality kept, as the rung actually run
+    uint32_t changes = 0;
+};
+
+ReplayResult replay(const Trace& trace, Controller& controller) {
+    Noise noise(0x9e3779b9u);
+    Settings active = controller.initial();
+    std::deque<std::pair<uint32_t, Settings>> pending;     // (first pair, settings)
+    std::vector<bool> violated(trace.pairs);
+    double scaleSum = 0.0;
+    uint32_t changes = 0;
+    Settings ran{snapToLadder(active.modelScale), active.searchRadius};
+
+    for (uint32_t n = 0; n < trace.pairs; n++) {
+        while (!pending.empty() && pending.front().first <= n) {
+            active = pending.front().second;
+            pending.pop_front();
+        }
+
+        float scale = snapToLadder(active.modelScale);
+        if (scale != ran.modelScale || active.searchRadius != ran.searchRadius) changes++;
+        ran = {scale, active.searchRadius};
+        float load = trace.load(n, noise);
+
+        PairResult pair;
+        pair.settings = {scale, active.searchRadius};
+        pair.frames = trace.frames;
+        pair.synthesizeMs = synthesizeMs(scale, trace.frames) * load * noise.jitter();
+        pair.estimateMs = trace.estimate ? estimateMs(active.searchRadius) * load * noise.jitter()
+                                         : -1.0f;
+
+        float frameMs = (pair.synthesizeMs + std::max(pair.estimateMs, 0.0f)) / trace.frames;
+        violated[n] = frameMs > BUDGET_MS;
+        scaleSum += scale;
+
+        if (auto next = controller.onPair(pair)) {
+            pending.emplace_back(n + 1 + PIPELINE_LAG, *next);
+        }
+    }
+
+    ReplayResult result;
+    result.violationRate = static_cast<float>(std::count(violated.begin(), violated.end(), true)) /
+                           static_cast<float>(trace.pairs);
+    result.meanScale = static_cast<float>(scaleSum / trace.pairs);
+    result.changes = changes;
+
+    const uint32_t allowed = static_cast<uint32_t>(CONVERGENCE_WINDOW * VIOLATION_TOLERANCE);
+    for (size_t c = 0; c < trace.changes.size(); c++) {
+        uint32_t start = trace.changes[c];
+        uint32_t end = c + 1 < trace.changes.size() ? trace.changes[c + 1] : trace.pairs;
+
+        uint32_t converged = end - start;   // Never, within the segment
+        for (uint32_t k = start; k + CONVERGENCE_WINDOW <= end; k++) {
+            uint32_t misses = static_cast<uint32_t>(
+                std::count(violated.begin() + k, violated.begin() + k + CONVERGENCE_WINDOW, true));
+            if (misses <= allowed) {
+                converged = k - start;
+                break;
+            }
+        }
+        result.convergencePairs = std::max(result.convergencePairs, converged);
+    }
+    return result;
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-20s %-11s %11s %12s %10s %8s\n",
+                "trace", "controller", "violations", "convergence", "mean scale", "changes");
+
+    for (const Trace& trace : traces()) {
+        CostModelController model;
+        HeuristicController heuristic;
+        ReplayResult m = replay(trace, model);
+        ReplayResult h = replay(trace, heuristic);
+
+        for (auto [controller, r] : {std::pair{static_cast<Controller*>(&model), m},
+                                     std::pair{static_cast<Controller*>(&heuristic), h}}) {
+            std::printf("%-20s %-11s %10.1f%% %6u pairs %10.2f %8u\n", trace.name,
+                        controller->name(), r.violationRate * 100.0f, r.convergencePairs,
+                        r.meanScale, r.changes);
+        }
+
+        CHECK(m.violationRate <= h.violationRate, "%s: %.1f%% vs %.1f%% over budget",
+              trace.name, m.violationRate * 100.0f, h.violationRate * 100.0f);
+        CHECK(m.convergencePairs <= h.convergencePairs, "%s: converged in %u vs %u pairs",
+              trace.name, m.convergencePairs, h.convergencePairs);
+    }
+
+    // Replays are deterministic: a second run matches the first exactly
+    const Trace& trace = traces()[1];
+    CostModelController first, second;
+    ReplayResult a = replay(trace, first);
+    ReplayResult b = replay(trace, second);
+    CHECK(a.violationRate == b.violationRate && a.convergencePairs == b.convergencePairs &&
+          a.meanScale == b.meanScale, "%s replayed differently", trace.name);
+
+    // A user quality change moves the controller to the engine's rung
+    TimingController controller;
+    Config config;
+    controller.init(config);
+    for (float quality : {0.1f, 0.5f, 0.9f}) {
+        controller.setQuality(quality);
+        CHECK(controller.getState().currentScale == modelScaleForQuality(quality),
+              "quality %.1f left scale %.2f", quality, controller.getState().currentScale);
+    }
+
+    std::printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}